@@ -9,8 +9,16 @@
 extern void ReadAcc(void);
 extern void CalibrateAcc(int8_t type);
 extern void get_raw_accs(void);
+extern void UpdateAccOrientation(void);
+extern void ScaleAccs(int16_t* vector);
+extern void AccCalStart(void);
+extern bool AccCalSide(void);
+extern bool AccCalStore(int16_t* average);
+extern uint8_t AccCalSides(void);
+extern void AccCalSave(void);
 
 extern int16_t accADC[NUMBEROFAXIS];
 extern int16_t accADC_P1[NUMBEROFAXIS];
 extern int16_t accADC_P2[NUMBEROFAXIS];
 extern float accVertf;
+extern uint8_t AccCalMask;
@@ -11,5 +11,17 @@
 // Uncomment this to enable the error log
 //#define ERROR_LOG
 
+// Uncomment this to pace the main loop to the MPU6050 sample clock
+//#define DATA_READY_SYNC
+
+// Uncomment this to average all gyro samples taken since the last loop
+// via the MPU6050 FIFO. Not for use with DATA_READY_SYNC.
+//#define GYRO_FIFO
+
+// Uncomment this to interpolate the stick channels between RC frames.
+// Smoother servo and motor steps on slow RC formats, but every stick
+// move then arrives one RC frame period later (about 22ms on PPM).
+//#define RC_INTERPOLATE
+
 // Enable debugging messages
 //#define DEBUG_ON
@@ -11,6 +11,16 @@ extern void Save_Config_to_EEPROM(void);
 extern void Set_EEPROM_Default_Config(void);
 extern void Load_eeprom_preset(uint8_t preset);
 
+extern volatile bool EEPROM_save_pending;
+
+extern void Init_EEPROM_log(void);
+extern void Add_EEPROM_log(uint8_t event);
+extern uint8_t Read_EEPROM_log(int8_t* log, uint8_t length);
+
+extern bool Check_model(uint8_t model);
+extern bool Load_model(uint8_t model);
+extern bool Save_model(uint8_t model);
+
 extern const int8_t JR[];
 extern const int8_t FUTABA[];
 extern const int8_t MPX[];
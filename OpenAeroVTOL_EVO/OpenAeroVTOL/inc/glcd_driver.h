@@ -1,6 +1,7 @@
 /*********************************************************************
  * glcd_driver.h
  ********************************************************************/
+#include <stdbool.h>
 
 //***********************************************************
 //* LCD Defines
@@ -87,6 +88,8 @@ void st7565_data(uint8_t c);
 void st7565_init(void);
 void st7565_set_brightness(uint8_t val);
 void write_buffer(uint8_t *buffer);
+void queue_buffer(uint8_t *buffer);
+bool stream_buffer(uint8_t *buffer, uint8_t bytes);
 void clear_buffer(uint8_t *buff);
 void write_logo_buffer(uint8_t *buffer);
 void clear_screen(void);
@@ -10,6 +10,17 @@ extern void ReadGyros(void);
 extern void CalibrateGyrosFast(void);
 extern bool CalibrateGyrosSlow(void);
 extern void get_raw_gyros(void);
+extern void UpdateOrientation(void);
+extern void CompileOrientation(orient_t* orient, const int8_t* order, const int8_t* pol);
+extern void UpdateOrientationWeights(orient_t* orient);
+extern void AlignBoard(int16_t* vector);
+extern void TrackGyroBias(void);
+extern bool UseGyroBias(void);
+extern void TempCompensate(int16_t* vector, const int16_t* tempco);
+extern void TempCoStart(void);
+extern void TempCoSample(void);
+extern int16_t TempCoSpan(void);
+extern void TempCoSave(void);
 
 extern int16_t gyroADC[NUMBEROFAXIS];		// Holds 16-bit gyro values
 extern int16_t gyroADCalt[NUMBEROFAXIS];	// Holds Gyro data - always in RPY order (Combined - Alternate)
@@ -2,13 +2,41 @@
  * i2c.h
  ********************************************************************/
 
+//***********************************************************
+//* Defines
+//***********************************************************
+
+#define SENSOR_SAMPLE_SIZE	14		// MPU6050 registers 0x3B to 0x48
+#define SENSOR_ACC			0		// Offsets of each sensor in SensorSample[]
+#define SENSOR_TEMP			6
+#define SENSOR_GYRO			8
+
+#ifdef GYRO_FIFO
+#define SENSOR_RATE			1000	// MPU6050 sample rate (Hz) when GYRO_FIFO is defined
+#else
+#define SENSOR_RATE			500		// MPU6050 sample rate (Hz) when DATA_READY_SYNC is defined
+#endif
+#define SENSOR_READY_TIMEOUT ((19531 * 2) / SENSOR_RATE) // Two sample periods in T2 ticks
+
 //***********************************************************
 //* Externals
 //***********************************************************
 
-extern void writeI2Cbyte(uint8_t address, uint8_t location, uint8_t value);
-extern void readI2CbyteArray(uint8_t address, uint8_t location, uint8_t *array,uint8_t size);
+extern uint8_t SensorSample[SENSOR_SAMPLE_SIZE];
+extern int16_t MPU6050_temp;
+extern uint16_t I2C_Errors;
+extern void ReadSensors(void);
+extern void StartSensorRead(void);
+extern void WaitSensorReady(void);
+extern void ResetGyroFIFO(void);
+extern volatile i2c_transfer_t I2C_Transfer;
+
+extern bool writeI2Cbyte(uint8_t address, uint8_t location, uint8_t value);
+extern bool readI2CbyteArray(uint8_t address, uint8_t location, uint8_t *array,uint8_t size);
+extern void readI2CbyteArrayAsync(uint8_t address, uint8_t location, uint8_t *array,uint8_t size);
+extern bool waitI2Casync(void);
 extern void init_i2c_gyros(void);
 extern void init_i2c_accs(void);
+extern void init_i2c_lpf(void);
 
 
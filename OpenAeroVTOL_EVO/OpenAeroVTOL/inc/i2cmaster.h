@@ -133,11 +133,23 @@ extern unsigned char i2c_rep_start(unsigned char addr);
 /**
  @brief Issues a start condition and sends address and transfer direction 
    
- If device is busy, use ack polling to wait until device ready 
+ If device is busy, use ack polling to wait until device ready.
+ Gives up after a few attempts.
  @param    addr address and transfer direction of I2C device
- @return   none
+ @retval   0   device accessible 
+ @retval   1   failed to access device 
+ */
+extern unsigned char i2c_start_wait(unsigned char addr);
+
+/**
+ @brief Clock a stuck slave off the bus, send STOP and restart the TWI
+ @param void
+ @return none
  */
-extern void i2c_start_wait(unsigned char addr);
+extern void i2c_recover(void);
+
+/** Set when any I2C operation fails or times out. Cleared by the caller. */
+extern unsigned char i2c_error;
 
  
 /**
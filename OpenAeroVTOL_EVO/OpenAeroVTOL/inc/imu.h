@@ -15,5 +15,8 @@ extern float intervalf;
 extern void imu_update(uint32_t period);
 extern void reset_IMU(void);
 
-extern const float LPF_lookup[8] PROGMEM;
-extern const float LPF_lookup_HS[8] PROGMEM;
\ No newline at end of file
+extern void UpdateFilters(void);
+
+extern lpf_t AccLPF;
+extern lpf_t GyroLPF;
+extern int8_t MPU6050_LPF_hw;
\ No newline at end of file
@@ -88,6 +88,12 @@ extern CONFIG_STRUCT Config;
 #define CPPM			REGISTER_BIT(PINB,2)	// Same physical port as RUDDER input
 #define CPPM_DIR 		REGISTER_BIT(DDRB,2)
 
+// Spektrum format flags (SpektrumFormat)
+#define SPEKTRUM_RES_KNOWN	0x01		// Resolution detected
+#define SPEKTRUM_2048		0x02		// 11-bit data, otherwise 10-bit
+#define SPEKTRUM_RATE_KNOWN	0x04		// Frame period measured
+#define SPEKTRUM_11MS		0x08		// 11ms frames, otherwise 22ms
+
 //***********************************************************
 // Enumeration
 //***********************************************************
@@ -101,7 +107,7 @@ enum Orientation	{UP_BACK = 0, UP_LEFT, UP_FRONT, UP_RIGHT,
 					};
 enum Old_Orientation	{HORIZONTAL = 0, VERTICAL, UPSIDEDOWN, AFT, SIDEWAYS, PITCHUP};
 enum RPYArrayIndex 	{ROLL = 0, PITCH, YAW, ZED};
-enum RX_Modes		{CPPM_MODE = 0, PWM, SBUS, SPEKTRUM, XTREME, MODEB, SUMD};
+enum RX_Modes		{CPPM_MODE = 0, PWM, SBUS, SPEKTRUM, XTREME, MODEB, SUMD, IBUS, CRSF};
 enum RX_Sequ		{JRSEQ = 0, FUTABASEQ, MPXSEQ, CUSTOM};
 enum Polarity 		{NORMAL = 0, REVERSED};
 enum KKoutputs 		{OUT1 = 0, OUT2, OUT3, OUT4, OUT5, OUT6, OUT7, OUT8};
@@ -120,7 +126,7 @@ enum Curve			{LINEAR = 0, SINE, SQRTSINE};
 enum Filters		{HZ5 = 0, HZ10, HZ21, HZ44, HZ94, HZ184, HZ260, NOFILTER};
 enum Presets		{QUADX = 0, QUADP, TRICOPTER, BLANK, OPTIONS};
 enum Frames			{BASIC = 0, EDIT, ABORT, LOG, CURVE, OFFSET};
-enum Errors			{NOERR = 0, REBOOT, MANUAL, NOSIGNAL, TIMER};
+enum Errors			{NOERR = 0, REBOOT, MANUAL, NOSIGNAL, TIMER, RXERROR};
 enum Reference		{NO_ORIENT = 0, EARTH, MODEL};
 enum Curves			{P1_THR_CURVE = 0, P2_THR_CURVE, P1_COLL_CURVE, P2_COLL_CURVE, GEN_CURVE_C, GEN_CURVE_D};
 enum Psych			{MONOPOLAR = 0, BIPOLAR};
@@ -131,9 +137,12 @@ enum Psych			{MONOPOLAR = 0, BIPOLAR};
 
 enum GlobalError	{THROTTLE_HIGH = 0, NO_SIGNAL, DISARMED, LVA_ALARM, BUZZER_ON};
 enum FlightFlags	{RxActivity = 0, ARM_blocker};
-enum MainFlags		{inv_cal_done_P1 = 0, normal_cal_done_P1, inv_cal_done_P2, normal_cal_done_P2};
+enum MainFlags		{inv_cal_done_P1 = 0, normal_cal_done_P1, inv_cal_done_P2, normal_cal_done_P2, tempco_done, acc_6pos_done};
 enum SensorFlags	{RollGyro = 0, PitchGyro, YawGyro, RollAcc, PitchAcc, ZDeltaAcc, MotorMarker};
 enum ScaleFlags		{RollScale = 0, PitchScale, YawScale, AccRollScale, AccPitchScale, AccZScale};
 enum ReverseFlags	{RollReverse = 0, PitchReverse, YawReverse, AccRollReverse, AccPitchReverse, AccZReverse};
+enum I2C_States		{I2C_IDLE = 0, I2C_BUSY, I2C_DONE, I2C_ERROR};
+enum Migration		{MIG_MOVE = 0, MIG_FILL, MIG_DEFAULT, MIG_AND, MIG_V1_0, MIG_V1_1, MIG_V1_2, MIG_V1_3B14, MIG_V1_3B15};
+enum DerivedFlags	{TriggerDirty = 0, ProfileDirty, TravelDirty, ChOrderDirty, FiltersDirty, OrientDirty, RxDirty};
 
 #endif //IO_CFG_H
@@ -16,8 +16,24 @@ extern volatile uint8_t ch_num;
 extern volatile bool Interrupted;
 extern volatile bool JitterFlag;
 extern volatile bool JitterGate;
+extern volatile bool RxFrameReady;
+extern volatile rx_stats_t RxStats;
 extern volatile uint16_t FrameRate;
+extern volatile uint8_t RxChannelFresh;
+extern volatile uint8_t SpektrumFormat;
+extern uint16_t SpektrumMask10;
+extern uint16_t SpektrumMask11;
+extern uint8_t SpektrumGuess;
 
 extern uint16_t TIM16_ReadTCNT1(void);
 extern void init_int(void);
-extern void Disable_RC_Interrupts(void);
\ No newline at end of file
+extern void Disable_RC_Interrupts(void);
+
+// Serial RX protocol decoders
+extern bool Decode_Xtreme(uint8_t temp);
+extern bool Decode_SBus(uint8_t temp);
+extern bool Decode_Spektrum(uint8_t temp);
+extern bool Decode_ModeB(uint8_t temp);
+extern bool Decode_SUMD(uint8_t temp);
+extern bool Decode_IBus(uint8_t temp);
+extern bool Decode_CRSF(uint8_t temp);
\ No newline at end of file
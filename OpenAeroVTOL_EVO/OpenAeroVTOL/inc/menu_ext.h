@@ -8,6 +8,8 @@
 
 // Display-only screens
 extern void Display_status(void);
+extern void Display_rx_stats(void);
+extern bool Draw_status(void);
 extern void Display_balance(void);
 extern void Display_sensors(void);
 extern void Display_rcinput(void);
@@ -30,6 +32,7 @@ extern void add_log(uint8_t error);
 extern void menu_curves(void);
 extern void menu_channel(void);
 extern void menu_offsets(void);
+extern void menu_models(void);
 
 extern  uint8_t button;
 
@@ -9,9 +9,13 @@
 extern void ProcessMixer(void);
 extern void UpdateServos(void);
 extern void UpdateLimits(void);
+extern void UpdateDerived(void);
+extern void Mark_config_dirty(void* setting);
 extern void get_preset_mix(const channel_t*);
 extern int16_t scale32(int16_t value16, int16_t multiplier16);
 extern int16_t scale_percent(int8_t value);
 extern int16_t scale_percent_nooffset(int8_t value);
 extern int16_t scale_micros(int8_t value);
 extern int16_t Process_curve(uint8_t curve, uint8_t type, int16_t input_value);
+
+extern uint8_t Config_dirty;
@@ -33,6 +33,8 @@
 #define THROTTLEOFFSET 1250				// Mixer offset needed to reduce the output center to MOTORMIN
 
 #define LOGLENGTH	20					// Log length for debugging
+#define LATENCY_BINS 8					// Number of RC latency histogram bins
+#define MODELS 4						// Number of model memories in eeprom
 
 /*********************************************************************
  * Type definitions
@@ -58,6 +60,13 @@ typedef struct
 	int16_t		maximum;
 } servo_limits_t;
 
+// Software LPF coefficients (8)
+typedef struct
+{
+	float		keep;					// Share of the last output kept each loop
+	float		gain;					// Share of the new input. 1.0 when bypassed.
+} lpf_t;
+
 // Flight_control type (20)
 typedef struct
 {
@@ -84,12 +93,9 @@ typedef struct
 
 } flight_control_t;
 
-// Channel mixer definition 34 bytes
+// Channel mixer definition 30 bytes
 typedef struct
 {
-	int16_t		P1_value;				// Current value of this channel at P1
-	int16_t		P2_value;				// Current value of this channel at P2
-	
 	// Mixer menu (30 bytes, 30 items)
 	int8_t		Motor_marker;			// Motor/Servo marker
 
@@ -128,24 +134,43 @@ typedef struct
 
 } channel_t;
 
-// Config settings structure (size)[offset]
+// Values worked out from the settings, never saved (size)[offset]
 typedef struct
 {
-	// Signature (1)[0]
-	uint8_t		setup;					// Byte to identify if already setup
-
-	// Menu adjustable items
-	// RC settings (8)[1]
+	// RC settings (8)[0]
 	int8_t		ChannelOrder[MAX_RC_CHANNELS];	// Assign channel numbers to hard-coded channel order
 										// OpenAero2 uses Thr, Ail, Ele, Rud, Gear, Aux1, Aux2, Aux3
 										// THROTTLE will always return the correct data for the assigned throttle channel
 										// AILERON will always return the correct data for the assigned aileron channel
 										// ELEVATOR will always return the correct data for the assigned elevator channel
 										// RUDDER will always return the correct data for the assigned rudder channel
-	// Servo travel limits (32)[9]
+	// Servo travel limits (32)[8]
 	servo_limits_t	Limits[MAX_OUTPUTS];// Actual, respanned travel limits to save recalculation each loop
 
-	// RC items (12)[41]
+	// Servo travel limits (32)[40]
+	int32_t		Raw_I_Limits[FLIGHT_MODES][NUMBEROFAXIS+1];		// Actual, unspanned I-term output limits to save recalculation each loop (RPY + Z) 4 x 2 x 4 = 32
+	
+	// Servo constraints (32)[72]
+	int32_t		Raw_I_Constrain[FLIGHT_MODES][NUMBEROFAXIS+1];	// Actual, unspanned I-term input limits to save recalculation each loop (RPY + Z) 4 x 2 x 4 = 32
+
+	// Triggers (2)[104]
+	uint16_t	PowerTriggerActual;		// LVA alarm * 10;
+
+	// Mixer outputs (32)[106]
+	int16_t		P1_value[MAX_OUTPUTS];	// Current value of each channel at P1
+	int16_t		P2_value[MAX_OUTPUTS];	// Current value of each channel at P2
+
+	// [138]
+} derived_t;
+
+// Config settings structure (size)[offset]
+typedef struct
+{
+	// Signature (1)[0]
+	uint8_t		setup;					// Byte to identify if already setup
+
+	// Menu adjustable items
+	// RC items (12)[1]
 	int8_t		RxMode;					// PWM, CPPM or serial types
 	int8_t		Servo_rate;				// PWM rate for (Low = ~50Hz, RCSync = as per RX, High = ~200Hz)
 	int8_t		PWM_Sync;				// Channel to sync to in PWM mode
@@ -159,19 +184,10 @@ typedef struct
 	int8_t		Vibration;				// Vibration test mode on/off
 	int8_t		AccVertFilter;			// Acc Z filter for I-terms in 1/100%
 	
-	// Flight mode settings (40)[53]
+	// Flight mode settings (40)[13]
 	flight_control_t FlightMode[FLIGHT_MODES];	// Flight control settings
 
-	// Servo travel limits (32)[93]
-	int32_t		Raw_I_Limits[FLIGHT_MODES][NUMBEROFAXIS+1];		// Actual, unspanned I-term output limits to save recalculation each loop (RPY + Z) 4 x 2 x 4 = 32
-	
-	// Servo constraints (32)[125]
-	int32_t		Raw_I_Constrain[FLIGHT_MODES][NUMBEROFAXIS+1];	// Actual, unspanned I-term input limits to save recalculation each loop (RPY + Z) 4 x 2 x 4 = 32
-
-	// Triggers (2)[157]
-	uint16_t	PowerTriggerActual;		// LVA alarm * 10;
-
-	// General items (12)[159]
+	// General items (15)[53]
 	int8_t		Orientation_P2;			// P2 orientation
 	int8_t		P1_Reference;			// Hover plane of reference	(NO, EARTH, VERT_AP)
 	int8_t		Contrast;				// Contrast setting
@@ -184,79 +200,140 @@ typedef struct
 	int8_t		CF_factor;				// Autolevel correction rate
 	int8_t		Preset;					// Mixer preset
 	int8_t		Buzzer;					// Buzzer control ON/OFF
+	int8_t		BoardAngle[NUMBEROFAXIS];// Fine board alignment in degrees (+/-45) about the board's roll, pitch and yaw axes
 	
-	// Channel configuration (272)[171]
+	// Channel configuration (240)[68]
 	channel_t	Channel[MAX_OUTPUTS];	// Channel mixing data	
 
-	// Servo menu (24)[443]
+	// Servo menu (24)[308]
 	int8_t		Servo_reverse[MAX_OUTPUTS];	// Reversal of output channel
 	int8_t		min_travel[MAX_OUTPUTS];	// Minimum output value (-125 to 125)
 	int8_t		max_travel[MAX_OUTPUTS];	// Maximum output value (-125 to 125)
 
-	// RC inputs (16)[467]
+	// RC inputs (16)[332]
 	uint16_t 	RxChannelZeroOffset[MAX_RC_CHANNELS];	// RC channel offsets for actual radio channels
 
-	// P1 Acc zeros (12)[483]
+	// P1 Acc zeros (12)[348]
 	int16_t		AccZero_P1[NUMBEROFAXIS];	// P1 Acc calibration results. Note: Acc-Z zero centered on 1G (about +124)
 	int16_t		AccZeroNormZ_P1;			// Acc-Z zero for normal Z values
 	int16_t		AccZeroInvZ_P1;				// Acc-Z zero for inverted Z values
 	int16_t		AccZeroDiff_P1;				// Difference between normal and inverted Acc-Z zeros
 
-	// Gyro zeros (6)[495]
+	// Gyro zeros (6)[360]
 	int16_t		gyroZero_P1[NUMBEROFAXIS];		// NB. These are now for P1 only
 
-	// Airspeed zero (2)[501]
+	// Airspeed zero (2)[366]
 	int16_t		AirspeedZero;			// Zero airspeed sensor offset
 
-	// Flight mode (1)[503]
+	// Flight mode (1)[368]
 	int8_t		FlightSel;				// User set flight mode
 
-	// Adjusted trims (8)[504]
+	// Adjusted trims (8)[369]
 	int16_t		Rolltrim[FLIGHT_MODES];	// User set trims * 100
 	int16_t		Pitchtrim[FLIGHT_MODES];
 
-	// Sticky flags (1)[512]
+	// Sticky flags (1)[377]
 	uint8_t		Main_flags;				// Non-volatile flags
 
-	// Misc (2)[513]
+	// Misc (2)[378]
 	int8_t		RudderPol;				// Rudder RC input polarity (V1.1 stops here...)
 	int8_t		AileronPol;				// Aileron RC input polarity
-		
-	// Error log (21)[515]
-	int8_t		log_pointer;
-	int8_t		Log[LOGLENGTH];
 	
-	// P2 Acc zeros (12)[536]
+	// P2 Acc zeros (12)[380]
 	int16_t		AccZero_P2[NUMBEROFAXIS];	// P2 Acc calibration results. Note: Acc-Z zero centered on 1G (about +124)
 	int16_t		AccZeroNormZ_P2;			// Acc-Z zero for normal Z values
 	int16_t		AccZeroInvZ_P2;				// Acc-Z zero for inverted Z values
 	int16_t		AccZeroDiff_P2;				// Difference between normal and inverted Acc-Z zeros
 	
-	// P2 Gyro zeros (6)[548]
+	// P2 Gyro zeros (6)[392]
 	int16_t		gyroZero_P2[NUMBEROFAXIS];		// NB. These are for P2 only
 
-	// Advanced items (1) [554]
+	// Advanced items (1) [398]
 	int8_t		Orientation_P1;			// P1 orientation
 	
-	// Curves (48) [555]
+	// Curves (48) [399]
 	curve_t		Curve[NUMBEROFCURVES];
 	
-	// Custom channel order (8) [603]
+	// Custom channel order (8) [447]
 	int8_t		CustomChannelOrder[MAX_RC_CHANNELS];
 	
-	// Output offsets (64) [611]
+	// Output offsets (64) [455]
 	curve_t		Offsets[MAX_OUTPUTS];
 	
-	// Misc (1)[675]
+	// Misc (1)[519]
 	int8_t		ElevatorPol;			// Elevator RC input polarity
 
-	// [676]
-
-
+	// Temperature compensation (14)[520]
+	int16_t		TempRef;				// MPU6050 temperature when the coefficients were learned
+	int16_t		GyroTempCo[NUMBEROFAXIS];// Gyro X, Y, Z drift in LSB per 65536 temperature counts
+	int16_t		AccTempCo[NUMBEROFAXIS];// Acc X, Y, Z drift in LSB per 65536 temperature counts
+
+	// Six-position acc calibration (12)[534]
+	int16_t		AccOffset[NUMBEROFAXIS];// Acc X, Y, Z chip offsets
+	int16_t		AccScale[NUMBEROFAXIS];	// Acc X, Y, Z scale corrections (16384 = 1.0)
+
+	// End of saved settings [546]
+
+	// Values worked out from the settings above (159)[546]
+	// Only valid once UpdateLimits() has run. The space is shared with the
+	// tail of the old V1.6 B3 layout so that it can be upgraded in place.
+	union
+	{
+		derived_t	Derived;
+		uint8_t		Upgrade[705 - 546];
+	};
 		
 } CONFIG_STRUCT;
 
 // Misc structures
+typedef struct
+{
+	uint16_t	frames;					// Good RC frames received
+	uint16_t	bad_crc;				// Frames dropped due to a bad checksum/CRC
+	uint16_t	frame_lost;				// S-Bus frame lost flags
+	uint16_t	uart_errors;			// Serial framing, parity and overrun errors
+	uint16_t	sync_loss;				// Number of times the RC signal was lost
+	uint16_t	latency[LATENCY_BINS];	// RC frame to servo pulse latency histogram (2ms bins)
+} rx_stats_t;
+
+// Board orientation compiled from the PROGMEM look-up tables
+typedef struct
+{
+	int8_t		orientation[FLIGHT_MODES];			// Orientations that this was compiled for
+	uint8_t		axis[FLIGHT_MODES][NUMBEROFAXIS];	// Raw sensor axis to use for each of ROLL, PITCH, YAW
+	int8_t		pol[FLIGHT_MODES][NUMBEROFAXIS];	// Polarity of each of ROLL, PITCH, YAW
+	int16_t		weight[FLIGHT_MODES][NUMBEROFAXIS];	// Polarity times the transition percentage for each of P1 and P2
+	int16_t		transition;							// Transition that the weights were calculated for
+} orient_t;
+
+typedef struct
+{
+	uint8_t		address;				// I2C device address
+	uint8_t		location;				// First register to read
+	uint8_t*	buffer;					// Destination
+	uint8_t		size;					// Number of bytes to read
+	uint8_t		index;					// Bytes read so far
+	uint8_t		state;					// I2C_IDLE, I2C_BUSY, I2C_DONE or I2C_ERROR
+} i2c_transfer_t;
+
+// EEPROM upgrade step (8)
+typedef struct
+{
+	uint8_t		signature;				// Old layout that this step belongs to
+	uint8_t		op;						// MIG_MOVE, MIG_FILL, MIG_DEFAULT, MIG_AND or a one-off conversion
+	uint16_t	dst;					// RAM location to change
+	uint16_t	src;					// RAM location to move from, fill value, default or mask
+	uint16_t	len;					// Number of bytes
+} migration_t;
+
+// Settings that derived values are worked out from (5)
+typedef struct
+{
+	uint16_t	start;					// Offset of the first setting in CONFIG_STRUCT
+	uint16_t	end;					// Offset just past the last one
+	uint8_t		derived;				// DerivedFlags to set when one of them changes
+} config_dep_t;
+
 typedef struct
 {
 	int8_t lower;						// Lower limit for menu item
@@ -2,9 +2,26 @@
  * uart.h
  ********************************************************************/
 
+//***********************************************************
+//* Type definitions
+//***********************************************************
+
+// Serial RX protocol descriptor
+typedef struct
+{
+	uint16_t	baud;						// UBRR0 divisor
+	uint8_t		ucsra;						// UCSR0A setup (U2X0)
+	uint8_t		ucsrc;						// UCSR0C setup (parity, stop bits, data bits)
+	uint8_t		sync;						// First byte of every frame. Zero if the protocol has none
+	bool		(*decoder)(uint8_t data);	// Byte handler. Returns true when the frame has ended
+} serial_rx_t;
+
 //***********************************************************
 //* Externals
 //***********************************************************
 
 extern void init_uart(void);
 extern uint16_t CRC16(uint16_t crc, uint8_t value);
+extern uint8_t CRC8_DVB_S2(uint8_t crc, uint8_t value);
+
+extern serial_rx_t SerialRX;
@@ -243,6 +243,35 @@
 // Beta 13	Changed back to the old bind timing method to solve power-up issues
 //			Beta 13 is Release V1.5
 //
+// V1.6		Based on OpenAeroVTOL V1.5 code.
+//
+// Beta 1	Serial RX protocols now table-driven (uart.c). Added FlySky IBUS and CRSF.
+//			Added optional RC interpolation of the primary channels between RC frames. Uncomment "RC_INTERPOLATE" in compiledefs.h to use.
+//			Added RC link statistics. Hold button 4 in the status screen to view.
+//			PWM RX inputs now all on pin-change interrupts, one pass per port.
+//			Spektrum resolution and frame period now auto-detected. Split 11ms frames used as they arrive.
+//			MPU6050 acc, temperature and gyro data now read in one I2C transaction.
+//			Sensor data now read by an interrupt-driven I2C transfer in the background.
+//			Added DATA_READY_SYNC option to pace the loop to the MPU6050 sample clock.
+//			Added GYRO_FIFO option to average all gyro samples between loops.
+//			I2C bus lock-ups are now recovered in flight. Last good sensor data held meanwhile.
+//			Board orientation compiled into RAM. Added board roll/pitch/yaw alignment to the General menu.
+//			Gyro zeros tracked in the background while disarmed. Arming uses them instead of a slow calibration.
+//			IMU slowly learns the remaining roll/pitch gyro bias from the accs in flight.
+//			Gyro and acc temperature compensation, learned from the Sensors screen.
+//			Six-position acc offset and scale calibration from the Level meter screen.
+//			MPU6050 LPF, sample rate and software LPFs worked out together from the loop rate.
+//			Settings are saved to eeprom in the background so the loop never stalls.
+//			Error log moved out of the config into a wear-levelled eeprom journal.
+//			Only the settings are saved. Limits, channel order and mixer outputs are worked out at start-up.
+//			Old eeprom layouts are upgraded in one pass from a table of moves and fills.
+//			Settings are kept in two CRC-checked eeprom banks so a save cut short can't lose them.
+//			Added four model memories, stored as differences from the defaults. Board calibrations are not part of a model.
+//			Menu edits now only rebuild the derived values that depend on the settings that changed.
+//			Start-up reads the newest eeprom bank just once when it is good and current.
+//			LCD updates only send the parts of the screen that have changed.
+//			Status screen is drawn a few glyph columns per loop within a TCNT2 budget and streamed to the LCD a few bytes per loop, so PWM no longer stops while it updates.
+//
 //***********************************************************
 //* Notes
 //***********************************************************
@@ -285,6 +314,7 @@
 #include "imu.h"
 #include "eeprom.h"
 #include "uart.h"
+#include "i2c.h"
 
 //***********************************************************
 //* Fonts
@@ -315,6 +345,8 @@
 #define PWM_PERIOD_WORST 20833		// PWM generation period (8.3ms - 120Hz)
 #define PWM_PERIOD_BEST 8333		// PWM generation period (3.333ms - 300Hz)
 #define FASTSYNCLIMIT 293			// Max time from end of PWM to next interrupt (15ms)
+#define LATENCY_BIN_SIZE 39			// RC latency histogram bin size. 39 * 1/19531 = 2ms
+#define LCD_STREAM_BYTES 8			// Bytes streamed to the LCD each loop. Setting an LCD address costs 4 bytes.
 
 //***********************************************************
 //* Code and Data variables
@@ -375,6 +407,12 @@ int main(void)
 	bool Interrupted_Clone = false;
 	bool SlowRC = true;
 	bool LastLoopOverdue = false;
+	bool LCDStreaming = false;
+	bool StatusDrawing = false;
+	bool StatusRxStats = false;
+#ifdef ERROR_LOG
+	bool RxErrorLogged = false;
+#endif
 
 	// 32-bit timers
 	uint32_t Arm_timer = 0;
@@ -393,6 +431,7 @@ int main(void)
 	uint16_t Save_TCNT1 = 0;
 	uint16_t ticker_16 = 0;
 	uint16_t fast_sync_timer = 0;
+	uint16_t Latency = 0;
 
 	// Timer incrementers
 	uint16_t RC_Rate_TCNT1 = 0;
@@ -421,6 +460,10 @@ int main(void)
 	uint32_t interval = 0;			// IMU interval
 	uint8_t transition_direction = P2;
 	uint16_t j;
+	uint16_t Latency_frame = 0;		// RC frame count at last latency measurement
+#ifdef ERROR_LOG
+	uint16_t RxErrorCount = 0;		// RC link error count when last disarmed
+#endif
 	
 	// Do all init tasks
 	init();
@@ -442,6 +485,17 @@ int main(void)
 			InterruptCounter++;
 		}
 
+		//************************************************************
+		//* Start reading the sensors in the background.
+		//* The I2C transfer overlaps the RC and housekeeping work
+		//* below and is collected by ReadSensors().
+		//************************************************************
+
+#ifdef DATA_READY_SYNC
+		WaitSensorReady();					// Wait for a fresh sample
+#endif
+		StartSensorRead();
+
 		//************************************************************
 		//* Once per second events
 		//* - Increment Status_seconds
@@ -466,7 +520,7 @@ int main(void)
 			}
 	
 			// Check if Vbat lower than trigger
-			if (GetVbat() < Config.PowerTriggerActual)
+			if (GetVbat() < Config.Derived.PowerTriggerActual)
 			{
 				General_error |= (1 << LVA_ALARM);	// Set LVA_Alarm flag
 			}
@@ -474,6 +528,20 @@ int main(void)
 			{
 				General_error &= ~(1 << LVA_ALARM);	// Clear LVA_Alarm flag
 			}		
+
+#ifdef ERROR_LOG
+			// Log RC link errors once per arming
+			if (General_error & (1 << DISARMED))
+			{
+				RxErrorCount = RxStats.bad_crc + RxStats.frame_lost;
+				RxErrorLogged = false;
+			}
+			else if ((!RxErrorLogged) && (RxErrorCount != (uint16_t)(RxStats.bad_crc + RxStats.frame_lost)))
+			{
+				add_log(RXERROR);
+				RxErrorLogged = true;
+			}
+#endif
 		}
 
 		//************************************************************
@@ -547,10 +615,21 @@ int main(void)
 				UpdateStatus_timer = 0;
 
 				// Update status screen
-				Display_status();
+				// Show the RC link statistics while button 4 is held
+				StatusRxStats = (BUTTON4 == 0);
 
-				// Prevent PWM output just after updating the LCD
-				PWMOverride = true;
+				// Build the list of items on the screen. The main loop draws them a little at a time 
+				// between RC frames, then streams the buffer to the LCD a few bytes at a time, so PWM can carry on.
+				if (StatusRxStats)
+				{
+					Display_rx_stats();
+				}
+				else
+				{
+					Display_status();
+				}
+
+				StatusDrawing = true;
 
 				// Wait for timeout
 				Menu_mode = WAITING_TIMEOUT_BD;
@@ -593,12 +672,10 @@ int main(void)
 				}
 
 				// Update status screen four times/sec while waiting to time out
-				else if (UpdateStatus_timer > (SECOND_TIMER >> 2))
+				// once the last update has been drawn and streamed to the LCD
+				else if ((UpdateStatus_timer > (SECOND_TIMER >> 2)) && !StatusDrawing && !LCDStreaming)
 				{
-					Menu_mode = PRESTATUS;
-
-					// Prevent PWM output
-					PWMOverride = true;
+					Menu_mode = STATUS;
 				}
 				
 				else
@@ -640,6 +717,9 @@ int main(void)
 			// In STATUS_TIMEOUT mode, the idle screen is displayed and the mode 
 			// changed to POSTSTATUS_TIMEOUT. 
 			case STATUS_TIMEOUT:
+				// Stop drawing the status screen
+				StatusDrawing = false;
+
 				// Pop up the Idle screen
 				idle_screen();
 				
@@ -687,6 +767,8 @@ int main(void)
 				// Disarm the FC
 				General_error |= (1 << DISARMED);
 				LED1 = 0;
+				// Stop drawing the status screen
+				StatusDrawing = false;
 				// Start the menu system
 				menu_main();
 				// Switch back to status screen when leaving menu
@@ -805,7 +887,13 @@ int main(void)
 				{
 					Arm_timer = 0;
 					General_error &= ~(1 << DISARMED);	// Set flags to armed (negate disarmed)
-					CalibrateGyrosSlow();					// Calibrate gyros (also saves to eeprom)
+
+					// Use the background gyro zeros if fresh, otherwise calibrate
+					if (!UseGyroBias())
+					{
+						CalibrateGyrosSlow();				// Calibrate gyros (also saves to eeprom)
+					}
+
 					LED1 = 1;								// Signal that FC is ready
 
 					Flight_flags |= (1 << ARM_blocker);		// Block motors for a little while to remove arm glitch
@@ -1336,6 +1424,12 @@ add_log(TIMER);
 				add_log(NOSIGNAL);
 			}
 #endif			
+			// Count each loss of signal
+			if (!Overdue)
+			{
+				RxStats.sync_loss++;
+			}
+
 			Overdue = true;	// This results in a "No Signal" error
 		}
 	
@@ -1343,8 +1437,15 @@ add_log(TIMER);
 		//* Read sensors
 		//************************************************************
 
+		ReadSensors();
 		ReadGyros();
 		ReadAcc();
+
+		// Keep the gyro zeros up to date while sitting disarmed
+		if (General_error & (1 << DISARMED))
+		{
+			TrackGyroBias();
+		}
 		
 		//************************************************************
 		//* Update IMU
@@ -1597,6 +1698,19 @@ add_log(TIMER);
 			}
 		} // Interrupted
 
+		//************************************************************
+		//* Draw the next part of the status screen, but only while no RC
+		//* frame is waiting for its PWM output. In FAST mode, only draw
+		//* between bursts, as each burst is sized to fit the RC gap.
+		//* Each call draws a glyph's columns or a band of pixels at a time
+		//* and stops after two TCNT2 ticks, so it takes about 0.3ms at most.
+		//************************************************************
+
+		if (StatusDrawing && !Interrupted && ((Config.Servo_rate != FAST) || PWMBlocked))
+		{
+			StatusDrawing = !Draw_status();
+		}
+
 		//************************************************************
 		//* Output PWM to ESCs/Servos where required, 
 		//* based on a very specific set of conditions
@@ -1753,6 +1867,27 @@ add_log(TIMER);
 			// Otherwise just output PWM normally
 			else
 			{
+				// Measure the time from the last RC frame to the first servo pulse after it
+				if (Latency_frame != RxStats.frames)
+				{
+					Latency_frame = RxStats.frames;
+					Latency = (RC_Timeout + (uint8_t)(TCNT2 - Servo_TCNT2)) / LATENCY_BIN_SIZE;
+
+					if (Latency >= LATENCY_BINS)
+					{
+						Latency = LATENCY_BINS - 1;
+					}
+
+					// Halve all bins before one overflows to keep the shape of the histogram
+					if (++RxStats.latency[Latency] == 0xFFFF)
+					{
+						for (i = 0; i < LATENCY_BINS; i++)
+						{
+							RxStats.latency[i] >>= 1;
+						}
+					}
+				}
+				
 				output_servo_ppm(ServoFlag);		// Output servo signal			
 			}
 
@@ -1780,6 +1915,14 @@ add_log(TIMER);
 			}
 		}
 	
+		//************************************************************
+		//* Stream any queued status screen changes to the LCD.
+		//* Only a few bytes are sent, and one part checked for changes,
+		//* per loop so that the loop time and PWM output are not disturbed.
+		//************************************************************
+
+		LCDStreaming = stream_buffer(buffer, LCD_STREAM_BYTES);
+
 		//************************************************************
 		//* Enable RC interrupts when ready (RC rate measured and RC interrupts OFF)
 		//* and just one PWM remains
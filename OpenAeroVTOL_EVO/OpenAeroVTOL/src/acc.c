@@ -14,6 +14,7 @@
 #include "compiledefs.h"
 #include <avr/pgmspace.h>
 #include <avr/io.h>
+#include <stdlib.h>
 #include <stdbool.h>
 #include <util/delay.h>
 #include "io_cfg.h"
@@ -26,6 +27,7 @@
 #include "menu_ext.h"
 #include "mixer.h"
 #include "rc.h"
+#include "gyros.h"
 
 //************************************************************
 // Prototypes
@@ -34,6 +36,13 @@
 void ReadAcc(void);
 void CalibrateAcc(int8_t type);
 void get_raw_accs(void);
+void UpdateAccOrientation(void);
+void ScaleAccs(int16_t* vector);
+void AccCalStart(void);
+bool AccCalSide(void);
+bool AccCalStore(int16_t* average);
+uint8_t AccCalSides(void);
+void AccCalSave(void);
 
 //************************************************************
 // Defines
@@ -42,6 +51,13 @@ void get_raw_accs(void);
 #define ACCFS16G	0x18		// 16G full scale
 #define ACCFS4G 	0x08		// 4G full scale
 #define ACCFS2G		0x00		// 2G full scale
+#define ACC_ONE_G	8192		// Raw reading for 1G at 4G full scale
+#define ACC_ZERO_G	128			// accADC[] reading for 1G
+#define ACC_Q14		16384		// 1.0 in the acc scale factors
+#define ACC_SIDE_MIN 6144		// Smallest reading on the vertical axis (0.75G)
+#define ACC_SIDE_MAX 2048		// Largest reading on the other axes (0.25G)
+#define ACC_SIDE_SAMPLES 64		// Samples averaged for each side
+#define ACC_SIDES_DONE 0x3F		// All six sides captured
 
 //***********************************************************
 // ROLL, PITCH, YAW mapping for alternate orientation modes
@@ -124,6 +140,9 @@ int16_t accADC[NUMBEROFAXIS];		// Holds Acc ADC values - always in RPY order (Co
 int16_t accADC_P1[NUMBEROFAXIS];	// Holds Acc ADC values - always in RPY order (P1)
 int16_t accADC_P2[NUMBEROFAXIS];	// Holds Acc ADC values - always in RPY order (P2)
 float accVertf = 0.0;				// Holds the level-zeroed Z-acc value. Used for height damping in hover only.
+orient_t Acc_Orient;				// Acc orientation, compiled from the tables above
+int16_t AccCalReading[NUMBEROFAXIS][2];	// Six-position readings, [axis][up, down]
+uint8_t AccCalMask = 0;				// Sides captured so far, bit (axis * 2) + down
 
 void ReadAcc()
 {
@@ -132,6 +151,12 @@ void ReadAcc()
 
 	get_raw_accs();					// Updates accADC_P1[] and accADC_P2[] (RPY)
 
+	// Polarity and transition weights only change when the transition moves
+	if (Acc_Orient.transition != transition)
+	{
+		UpdateOrientationWeights(&Acc_Orient);
+	}
+
 	// P1
 	// Use default Config.AccZero for Acc-Z if inverse calibration not done yet
 	// Actual zero is held in Config.AccZeroNormZ waiting for inverse calibration
@@ -162,22 +187,22 @@ void ReadAcc()
 		// Only need to do this if the orientations differ
 		if (Config.P1_Reference != NO_ORIENT)
 		{
-			// Change polarity - use the zeros from the appropriate calibrate
-			temp1 = ((accADC_P1[i] - Config.AccZero_P1[i]) * (int8_t)pgm_read_byte(&Acc_Pol[Config.Orientation_P1][i]));
-			temp2 = ((accADC_P2[i] - Config.AccZero_P2[i]) * (int8_t)pgm_read_byte(&Acc_Pol[Config.Orientation_P2][i]));
+			// Use the zeros from the appropriate calibrate
+			temp1 = accADC_P1[i] - Config.AccZero_P1[i];
+			temp2 = accADC_P2[i] - Config.AccZero_P2[i];
 			
-			// Get P1 value
-			temp1 = scale32(temp1, (100 - transition));
+			// Get P1 value with polarity
+			temp1 = scale32(temp1, Acc_Orient.weight[P1][i]);
 
-			// Get P2 value
-			temp2 = scale32(temp2, transition);
+			// Get P2 value with polarity
+			temp2 = scale32(temp2, Acc_Orient.weight[P2][i]);
 
 			// Sum the two values
 			accADC[i] = temp1 + temp2;
 		}
 		else
 		{
-			accADC[i] = ((accADC_P2[i] - Config.AccZero_P2[i]) * (int8_t)pgm_read_byte(&Acc_Pol[Config.Orientation_P2][i]));
+			accADC[i] = ((accADC_P2[i] - Config.AccZero_P2[i]) * Acc_Orient.pol[P2][i]);
 		}
 	}
 	
@@ -186,8 +211,8 @@ void ReadAcc()
 	if (Config.P1_Reference != NO_ORIENT)
 	{
 		// Change polarity - use the zeros from the appropriate calibrate
-		temp1 = ((accADC_P1[YAW] * (int8_t)pgm_read_byte(&Acc_Pol[Config.Orientation_P1][YAW]) - Config.AccZero_P1[YAW]));
-		temp2 = ((accADC_P2[YAW] * (int8_t)pgm_read_byte(&Acc_Pol[Config.Orientation_P2][YAW]) - Config.AccZero_P2[YAW]));
+		temp1 = ((accADC_P1[YAW] * Acc_Orient.pol[P1][YAW]) - Config.AccZero_P1[YAW]);
+		temp2 = ((accADC_P2[YAW] * Acc_Orient.pol[P2][YAW]) - Config.AccZero_P2[YAW]);
 			
 		// Get P1 value
 		temp1 = scale32(temp1, (100 - transition));
@@ -200,7 +225,7 @@ void ReadAcc()
 	}
 	else
 	{
-		accADC[YAW] = ((accADC_P2[YAW] * (int8_t)pgm_read_byte(&Acc_Pol[Config.Orientation_P2][YAW]) - Config.AccZero_P2[YAW]));
+		accADC[YAW] = ((accADC_P2[YAW] * Acc_Orient.pol[P2][YAW]) - Config.AccZero_P2[YAW]);
 	}
 		
 	// Recalculate current accVertf using filtered acc value
@@ -234,6 +259,7 @@ void ReadAcc()
 
 //***************************************************************
 // Fill accADC with RPY data appropriate to the board orientation
+// The data comes from the last ReadSensors().
 // Nice as it would be, we cannot remove zeros here as this is the
 // routine used by the zeroing calibration routine. Chicken | Egg.
 // We also cannot merge P1 and P2 here as each have their own zeros.
@@ -243,28 +269,36 @@ void get_raw_accs(void)
 {
 	int16_t RawADC[NUMBEROFAXIS];
 	uint8_t i;
-
-	// Get data from MPU6050
-	uint8_t Accs[6];
-
-	// Get the i2c data from the MPU6050
-	readI2CbyteArray(MPU60X0_DEFAULT_ADDRESS,MPU60X0_RA_ACCEL_XOUT_H,(uint8_t *)Accs,6);
-
-	// Reassemble data into accADC array and down sample to reduce resolution and noise.
+	uint8_t* Accs = &SensorSample[SENSOR_ACC];
+
+	// Reassemble the MPU6050's X, Y, Z data, remove temperature drift, offsets 
+	// and scale errors, then correct any board misalignment
+	RawADC[0] = (Accs[0] << 8) + Accs[1];
+	RawADC[1] = (Accs[2] << 8) + Accs[3];
+	RawADC[2] = (Accs[4] << 8) + Accs[5];
+	TempCompensate(RawADC, Config.AccTempCo);
+	ScaleAccs(RawADC);
+	AlignBoard(RawADC);
+
+	// Rearrange into accADC order.
 	// This notation is true to the chip, but not the board orientation.
-	RawADC[ROLL] = (Accs[0] << 8) + Accs[1];
-	RawADC[PITCH] = -((Accs[2] << 8) + Accs[3]);
-	RawADC[YAW] = (Accs[4] << 8) + Accs[5];
+	RawADC[PITCH] = -RawADC[PITCH];
 
-	// Reorient the data as per the board orientation	
+	// Reorient the data as per the board orientation and down sample to reduce resolution and noise.
 	for (i = 0; i < NUMBEROFAXIS; i++)
 	{
 		// Rearrange the sensors for both orientations
-		accADC_P1[i] = RawADC[(int8_t)pgm_read_byte(&ACC_RPY_Order[Config.Orientation_P1][i])] >> 6;
-		accADC_P2[i] = RawADC[(int8_t)pgm_read_byte(&ACC_RPY_Order[Config.Orientation_P2][i])] >> 6;
+		accADC_P1[i] = RawADC[Acc_Orient.axis[P1][i]] >> 6;
+		accADC_P2[i] = RawADC[Acc_Orient.axis[P2][i]] >> 6;
 	}
 }
 
+// Compile the acc orientation into RAM. Called from UpdateOrientation().
+void UpdateAccOrientation(void)
+{
+	CompileOrientation(&Acc_Orient, &ACC_RPY_Order[0][0], &Acc_Pol[0][0]);
+}
+
 //***************************************************************
 // Calibration routines
 // For V1.2 onwards we have to be able to calibrate both
@@ -289,6 +323,7 @@ void CalibrateAcc(int8_t type)
 			// Get average zero value (over 32 readings)
 			for (i = 0; i < 32; i++)
 			{
+				ReadSensors();
 				get_raw_accs();						// Updates accADC_P1[] and accADC_P2[] (RPY)
 				accZero[ROLL] += accADC_P2[ROLL];
 				accZero[PITCH] += accADC_P2[PITCH];
@@ -326,6 +361,7 @@ void CalibrateAcc(int8_t type)
 			// Get average zero value (over 32 readings)
 			for (i = 0; i < 32; i++)
 			{
+				ReadSensors();
 				get_raw_accs();						// Updates accADC_P1[] and accADC_P2[] (RPY)
 				accZero[ROLL] += accADC_P1[ROLL];
 				accZero[PITCH] += accADC_P1[PITCH];
@@ -373,6 +409,7 @@ void CalibrateAcc(int8_t type)
 
 				for (i = 0; i < 32; i++)
 				{
+					ReadSensors();
 					get_raw_accs();					// Updates accADC_P1[] and accADC_P2[] (RPY)
 					Config.AccZeroInvZ_P2 += accADC_P2[YAW];
 					_delay_ms(10);					// Get a better acc average over time
@@ -419,6 +456,7 @@ void CalibrateAcc(int8_t type)
 
 				for (i = 0; i < 32; i++)
 				{
+					ReadSensors();
 					get_raw_accs();					// Updates accADC_P1[] and accADC_P2[] (RPY)
 					Config.AccZeroInvZ_P1 += accADC_P1[YAW];
 					_delay_ms(10);					// Get a better acc average over time
@@ -457,6 +495,190 @@ void CalibrateAcc(int8_t type)
 	} // Calibrate inverted acc
 }
 
+//***************************************************************
+// Six-position calibration
+//
+// The board is placed still on each of its six sides in any order.
+// Each capture is sorted by whichever chip axis sees gravity. 
+// The up and down readings of each axis give its offset, and their
+// difference gives its scale error against 2G.
+//***************************************************************
+
+// Remove the chip offsets and scale errors from a raw X, Y, Z vector
+void ScaleAccs(int16_t* vector)
+{
+	int32_t	temp32;
+	uint8_t	i;
+
+	if (!(Config.Main_flags & (1 << acc_6pos_done)))
+	{
+		return;
+	}
+
+	for (i = 0; i < NUMBEROFAXIS; i++)
+	{
+		temp32 = ((int32_t)vector[i] - Config.AccOffset[i]) * Config.AccScale[i];
+
+		// Round, remove the Q14 scaling and keep within range
+		temp32 = (temp32 + (ACC_Q14 / 2)) >> 14;
+
+		if (temp32 > INT16_MAX)
+		{
+			temp32 = INT16_MAX;
+		}
+		else if (temp32 < INT16_MIN)
+		{
+			temp32 = INT16_MIN;
+		}
+
+		vector[i] = (int16_t)temp32;
+	}
+}
+
+void AccCalStart(void)
+{
+	AccCalMask = 0;
+}
+
+// Average the current side and store it. Returns false if the board is 
+// not resting squarely on a side.
+bool AccCalSide(void)
+{
+	int32_t	sum[NUMBEROFAXIS] = {0,0,0};
+	int16_t	average[NUMBEROFAXIS];
+	int16_t	RawADC[NUMBEROFAXIS];
+	uint8_t* Accs = &SensorSample[SENSOR_ACC];
+	uint8_t	i, j;
+
+	for (i = 0; i < ACC_SIDE_SAMPLES; i++)
+	{
+		ReadSensors();
+
+		// Same data as get_raw_accs() sees before the six-position correction
+		RawADC[0] = (Accs[0] << 8) + Accs[1];
+		RawADC[1] = (Accs[2] << 8) + Accs[3];
+		RawADC[2] = (Accs[4] << 8) + Accs[5];
+		TempCompensate(RawADC, Config.AccTempCo);
+
+		for (j = 0; j < NUMBEROFAXIS; j++)
+		{
+			sum[j] += RawADC[j];
+		}
+
+		_delay_ms(5);						// Get a better acc average over time
+	}
+
+	for (i = 0; i < NUMBEROFAXIS; i++)
+	{
+		average[i] = (int16_t)(sum[i] / ACC_SIDE_SAMPLES);
+	}
+
+	return AccCalStore(average);
+}
+
+// Sort an averaged reading into the side it belongs to
+bool AccCalStore(int16_t* average)
+{
+	uint8_t	i;
+	uint8_t	axis = 0;
+
+	// Find the axis that sees gravity
+	for (i = 1; i < NUMBEROFAXIS; i++)
+	{
+		if (abs(average[i]) > abs(average[axis]))
+		{
+			axis = i;
+		}
+	}
+
+	// Reject anything that isn't close to resting on a side
+	if (abs(average[axis]) < ACC_SIDE_MIN)
+	{
+		return false;
+	}
+
+	for (i = 0; i < NUMBEROFAXIS; i++)
+	{
+		if ((i != axis) && (abs(average[i]) > ACC_SIDE_MAX))
+		{
+			return false;
+		}
+	}
+
+	if (average[axis] > 0)
+	{
+		AccCalReading[axis][0] = average[axis];
+		AccCalMask |= (1 << (axis << 1));
+	}
+	else
+	{
+		AccCalReading[axis][1] = average[axis];
+		AccCalMask |= (1 << ((axis << 1) + 1));
+	}
+
+	return true;
+}
+
+// Number of sides captured so far
+uint8_t AccCalSides(void)
+{
+	uint8_t	i;
+	uint8_t	sides = 0;
+
+	for (i = 0; i < (NUMBEROFAXIS * 2); i++)
+	{
+		if (AccCalMask & (1 << i))
+		{
+			sides++;
+		}
+	}
+
+	return sides;
+}
+
+// Work out and store the offsets and scales once all six sides are in.
+// The old zeros included the chip offsets, so they are reset to those
+// of a perfect sensor. The normal and inverted calibrations are marked
+// as not done, so that they are redone to trim the board's mounting.
+void AccCalSave(void)
+{
+	int32_t	span;
+	uint8_t	i;
+
+	if (AccCalMask != ACC_SIDES_DONE)
+	{
+		return;
+	}
+
+	for (i = 0; i < NUMBEROFAXIS; i++)
+	{
+		// Up and down readings are a positive and negative 1G apart
+		span = (int32_t)AccCalReading[i][0] - AccCalReading[i][1];
+
+		Config.AccOffset[i] = (int16_t)(((int32_t)AccCalReading[i][0] + AccCalReading[i][1]) / 2);
+		Config.AccScale[i] = (int16_t)((((int32_t)ACC_ONE_G * 2 * ACC_Q14) + (span / 2)) / span);
+	}
+
+	for (i = 0; i < NUMBEROFAXIS; i++)
+	{
+		Config.AccZero_P1[i] = 0;
+		Config.AccZero_P2[i] = 0;
+	}
+
+	Config.AccZeroNormZ_P1 = ACC_ZERO_G;
+	Config.AccZeroInvZ_P1 = -ACC_ZERO_G;
+	Config.AccZeroDiff_P1 = ACC_ZERO_G;
+	Config.AccZeroNormZ_P2 = ACC_ZERO_G;
+	Config.AccZeroInvZ_P2 = -ACC_ZERO_G;
+	Config.AccZeroDiff_P2 = ACC_ZERO_G;
+
+	Config.Main_flags |= (1 << acc_6pos_done);
+	Config.Main_flags &= ~((1 << normal_cal_done_P1) | (1 << inv_cal_done_P1) |
+						   (1 << normal_cal_done_P2) | (1 << inv_cal_done_P2));
+
+	Save_Config_to_EEPROM();
+}
+
 //***************************************************************
 // Set up the MPU6050 (Acc)
 //***************************************************************
@@ -23,12 +23,14 @@
 #include "imu.h"
 #include "gyros.h"
 #include "rc.h"
+#include "i2c.h"
 
 //************************************************************
 // Prototypes
 //************************************************************
 
 void Display_balance(void);
+void Display_acccal(void);
 
 //************************************************************
 // Code
@@ -49,6 +51,7 @@ void Display_balance(void)
 		UpdateTransition();						// Update the transition variable
 
 		// Read accs
+		ReadSensors();
 		ReadAcc();
 
 		// Refresh accSmooth values
@@ -71,6 +74,7 @@ void Display_balance(void)
 
 			// Print bottom markers
 			LCD_Display_Text(12, (const unsigned char*)Wingdings, 2, 55); 	// Left
+			LCD_Display_Text(60, (const unsigned char*)Verdana8, 108, 55); 	// Calibrate
 
 			// Draw balance meter
 			drawrect(buffer, 0, 0, 128, 64, 1);		// Border
@@ -85,6 +89,17 @@ void Display_balance(void)
 			
 			count = 0;
 		}
+
+		// Six-position calibrate button pressed
+		if (BUTTON4 == 0)
+		{
+			Wait_BUTTON4();
+			Display_acccal();
+			clear_buffer(buffer);
+
+			// Don't let an abort also exit this screen
+			Wait_BUTTON1();
+		}
 	}
 
 	#ifdef KK2Mini
@@ -93,3 +108,67 @@ void Display_balance(void)
 	st7565_set_brightness(Config.Contrast);
 	#endif
 }
+
+//************************************************************
+// Guided six-position acc calibration
+// Rest the board still on each side in turn and press Cal.
+// One beep means the side was taken, three that it was rejected.
+//************************************************************
+
+void Display_acccal(void)
+{
+	uint8_t i;
+
+	AccCalStart();
+	clear_buffer(buffer);
+
+	// While ABORT not pressed
+	while(BUTTON1 != 0)
+	{
+		LCD_Display_Text(514,(const unsigned char*)Verdana8,5,13);	// Sides:
+		mugui_lcd_puts(utoa(AccCalSides(),pBuffer,10),(const unsigned char*)Verdana8,40,13);
+
+		// List the sides still to do
+		for (i = 0; i < (NUMBEROFAXIS * 2); i++)
+		{
+			if (!(AccCalMask & (1 << i)))
+			{
+				LCD_Display_Text((515 + i),(const unsigned char*)Verdana8,(5 + (i * 20)),27);
+			}
+		}
+
+		// Print bottom markers
+		LCD_Display_Text(280, (const unsigned char*)Verdana8, 0, 54); 	// Abort
+		LCD_Display_Text(60, (const unsigned char*)Verdana8, 108, 55); 	// Calibrate
+
+		// Update buffer
+		write_buffer(buffer);
+		clear_buffer(buffer);
+
+		if (BUTTON4 == 0)
+		{
+			// Wait until finger off button
+			Wait_BUTTON4();
+
+			// Pause until steady
+			_delay_ms(500);
+
+			if (AccCalSide())
+			{
+				menu_beep(1);
+			}
+			else
+			{
+				menu_beep(3);
+			}
+
+			// Save once all six sides are in
+			if (AccCalSides() == (NUMBEROFAXIS * 2))
+			{
+				AccCalSave();
+				menu_beep(5);
+				break;
+			}
+		}
+	}
+}
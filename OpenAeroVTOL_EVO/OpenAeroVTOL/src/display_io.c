@@ -26,6 +26,7 @@
 #include "servos.h"
 #include "imu.h"
 #include "pid.h"
+#include "i2c.h"
 
 //************************************************************
 // Prototypes
@@ -58,6 +59,7 @@ void Display_in_out(void)
 	while(BUTTON1 != 0)
 	{
 		RxGetChannels();
+		ReadSensors();
 		ReadGyros();
 		ReadAcc();
 
@@ -145,14 +147,14 @@ void Display_in_out(void)
 			temp = ServoOut[i];
 			
 			// Enforce min, max travel limits
-			if (temp > Config.Limits[i].maximum)
+			if (temp > Config.Derived.Limits[i].maximum)
 			{
-				temp = Config.Limits[i].maximum;
+				temp = Config.Derived.Limits[i].maximum;
 			}
 
-			else if (temp < Config.Limits[i].minimum)
+			else if (temp < Config.Derived.Limits[i].minimum)
 			{
-				temp = Config.Limits[i].minimum;
+				temp = Config.Derived.Limits[i].minimum;
 			}
 			
 			ServoOut[i] = temp;
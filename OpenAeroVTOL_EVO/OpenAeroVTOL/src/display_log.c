@@ -38,32 +38,26 @@ void add_log(uint8_t error);
 
 void add_log(uint8_t error)
 {
-	Config.Log[Config.log_pointer] = error;
-	Config.log_pointer++;
-	
-	if (Config.log_pointer >= (LOGLENGTH-1))
-	{
-		Config.log_pointer = (LOGLENGTH-1);
-	}
-	
-	// Save log and log pointer
-	Save_Config_to_EEPROM();
+	// Append one record to the eeprom journal in the background
+	Add_EEPROM_log(error);
 }
 
 void menu_log(void)
 {
 	int8_t	log_start = 0;
+	int8_t	log[LOGLENGTH];
 	
+	// Newest events, oldest first
+	Read_EEPROM_log(log, LOGLENGTH);
+
 	while(BUTTON1 != 0)
 	{
 		if (BUTTON4 == 0)
 		{
-			// Erase log
-			memset(&Config.Log[0],0,LOGLENGTH);
-			Config.log_pointer = 0;
-
-			// Save log and log pointer
-			Save_Config_to_EEPROM();			
+			// Erase log by marking the journal as cleared
+			Add_EEPROM_log(NOERR);
+			memset(log,0,LOGLENGTH);
+			Wait_BUTTON4();
 		}
 		
 		if (BUTTON2 == 0)
@@ -89,7 +83,7 @@ void menu_log(void)
 		// Print each line
 		for (uint8_t i = 0; i < 5; i++)
 		{
-			LCD_Display_Text(283 + Config.Log[log_start + i],(const unsigned char*)Verdana8,0,(i * 10)); // Throttle
+			LCD_Display_Text(283 + log[log_start + i],(const unsigned char*)Verdana8,0,(i * 10)); // Throttle
 		}
 
 		print_menu_frame(LOG);
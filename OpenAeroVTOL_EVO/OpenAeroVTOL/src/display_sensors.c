@@ -33,6 +33,15 @@
 //************************************************************
 
 void Display_sensors(void);
+void Display_tempcal(void);
+
+//************************************************************
+// Defines
+//************************************************************
+
+#define TEMP_OFFSET 12420				// MPU6050 temperature counts at 0 deg C (36.53 x 340)
+#define TEMP_SCALE 340					// MPU6050 temperature counts per deg C
+#define TEMPCO_MIN_SPAN 1700			// Smallest temperature range worth fitting (5 deg C)
 
 //************************************************************
 // Code
@@ -53,6 +62,7 @@ void Display_sensors(void)
 		RxGetChannels();						// Check state of transition switch
 		UpdateTransition();						// Update the transition variable
 
+		ReadSensors();
 		ReadGyros();
 		ReadAcc();
 
@@ -132,10 +142,15 @@ void Display_sensors(void)
 		LCD_Display_Text(229,(const unsigned char*)Verdana8,5,45);	// AccVert
 		mugui_lcd_puts(itoa((int16_t)accVertf,pBuffer,10),(const unsigned char*)Verdana8,40,45);
 
+		// Failed sensor reads
+		LCD_Display_Text(495,(const unsigned char*)Verdana8,75,45);	// I2C
+		mugui_lcd_puts(utoa(I2C_Errors,pBuffer,10),(const unsigned char*)Verdana8,97,45);
+
 		// Print bottom markers
 		LCD_Display_Text(12, (const unsigned char*)Wingdings, 0, 57); 	// Left
 		LCD_Display_Text(60, (const unsigned char*)Verdana8, 108, 55); 	// Calibrate
 		LCD_Display_Text(25, (const unsigned char*)Verdana8, 75, 55); 	// Inverted Calibrate		
+		LCD_Display_Text(511, (const unsigned char*)Verdana8, 38, 55); 	// Temperature calibrate
 
 		// Update buffer
 		write_buffer(buffer);
@@ -170,5 +185,77 @@ void Display_sensors(void)
 			_delay_ms(250);
 			CalibrateAcc(REVERSED);
 		}
+
+		// Temperature calibrate button pressed
+		if (BUTTON2 == 0)
+		{
+			// Wait until finger off button
+			while(BUTTON2 == 0)
+			{
+				_delay_ms(50);
+			}
+
+			Display_tempcal();
+
+			// Don't let an abort also exit this screen
+			Wait_BUTTON1();
+		}
+	}
+}
+
+//************************************************************
+// Learn the temperature coefficients while the board warms up
+// or cools down. The board must be kept still and level, as
+// the zeros are recalibrated when the result is saved.
+//************************************************************
+
+void Display_tempcal(void)
+{
+	int16_t	span;
+
+	TempCoStart();
+	clear_buffer(buffer);
+
+	// While ABORT not pressed
+	while(BUTTON1 != 0)
+	{
+		ReadSensors();
+		TempCoSample();
+
+		span = TempCoSpan();
+
+		LCD_Display_Text(512,(const unsigned char*)Verdana8,5,13);	// Temp:
+		LCD_Display_Text(513,(const unsigned char*)Verdana8,5,23);	// Span:
+		mugui_lcd_puts(itoa((MPU6050_temp + TEMP_OFFSET) / TEMP_SCALE,pBuffer,10),(const unsigned char*)Verdana8,40,13);
+		mugui_lcd_puts(itoa(span / TEMP_SCALE,pBuffer,10),(const unsigned char*)Verdana8,40,23);
+
+		// Print bottom markers
+		LCD_Display_Text(280, (const unsigned char*)Verdana8, 0, 54); 	// Abort
+
+		if (span >= TEMPCO_MIN_SPAN)
+		{
+			LCD_Display_Text(17, (const unsigned char*)Verdana8, 103, 54);	// Save
+		}
+
+		// Update buffer
+		write_buffer(buffer);
+		clear_buffer(buffer);
+
+		// Save once enough of a temperature range has been seen
+		if ((BUTTON4 == 0) && (span >= TEMPCO_MIN_SPAN))
+		{
+			// Wait until finger off button
+			Wait_BUTTON4();
+
+			TempCoSave();
+
+			// Pause until steady
+			_delay_ms(250);
+
+			// Zeros must be recalibrated with the compensation in place
+			CalibrateGyrosFast();
+			CalibrateAcc(NORMAL);
+			break;
+		}
 	}
 }
@@ -8,6 +8,7 @@
 
 #include <avr/io.h>
 #include <stdlib.h>
+#include <string.h>
 #include "io_cfg.h"
 #include "glcd_driver.h"
 #include "mugui.h"
@@ -21,25 +22,82 @@
 #include "main.h"
 #include "pid.h"
 #include "gyros.h"
-	
+#include "isr.h"
+
+//************************************************************
+// Defines
+//************************************************************
+
+#define STATUS_ITEMS 24			// Most items on a status page
+#define STATUS_TEXT_SIZE 7		// Longest number drawn, with its terminator
+#define STATUS_UNIT_PIXELS 64	// Most pixels drawn in one go (about 0.2ms)
+#define STATUS_DRAW_TICKS 2		// TCNT2 ticks (51.2us) after which no more units are started in a loop pass
+
+// Item types
+#define STATUS_CLEAR 0			// Clear the buffer
+#define STATUS_FILL 1			// Rectangle of one colour
+#define STATUS_PGM 2			// Text from flash
+#define STATUS_RAM 3			// Number
+
+//************************************************************
+// Types
+//************************************************************
+
+typedef struct
+{
+	uint8_t		type;
+	uint8_t		x;
+	uint8_t		y;
+	const unsigned char* font;
+	union
+	{
+		const char*	pgm;
+		char		ram[STATUS_TEXT_SIZE];
+		struct
+		{
+			uint8_t	w;
+			uint8_t	h;
+			uint8_t	colour;
+		} rect;
+	};
+} status_item_t;
+
 //************************************************************
 // Prototypes
 //************************************************************
 
 void Display_status(void);
+void Display_rx_stats(void);
+bool Draw_status(void);
+bool Draw_status_unit(status_item_t* item);
+void Status_start(void);
+void Status_text(uint16_t menuitem, const unsigned char* font, uint8_t x, uint8_t y);
+void Status_puts(char* s, const unsigned char* font, uint8_t x, uint8_t y);
+void Status_fill(uint8_t x, uint8_t y, uint8_t w, uint8_t h, uint8_t colour);
 
 //************************************************************
 // Code
 //************************************************************
 
+// The status pages are built as a list of items, then drawn from the
+// main loop a few dozen pixels at a time by Draw_status(), so that no
+// loop pass is held up for more than a fraction of a millisecond.
+
+status_item_t StatusItems[STATUS_ITEMS];
+uint8_t	StatusCount = 0;		// Items in the list
+uint8_t	StatusItem = 0;			// Item being drawn
+uint8_t	StatusChar = 0;			// Character of the item being drawn
+uint8_t	StatusPart = 0;			// Next column of that character, row of a rectangle or page of the buffer
+uint8_t	StatusXpos = 0;			// Position of that character from the start of the text
+
 void Display_status(void)
 {
 	int16_t temp;
-	uint16_t vbat_temp; 
+	uint16_t vbat_temp;
 	int8_t	pos1, pos2, pos3;
 	mugui_size16_t size;
 
-	clear_buffer(buffer);
+	Status_start();
 
 	//mugui_lcd_puts(itoa(((void*)&Config.PowerTriggerActual - (void*)&Config.setup),pBuffer,10),(const unsigned char*)Verdana8,0,0); // 157 - NG (not 149) out by 8
 	//mugui_lcd_puts(itoa(((void*)&Config.FlightMode[P1].Roll_P_mult - (void*)&Config.setup),pBuffer,10),(const unsigned char*)Verdana8,0,0); //53 - OK
@@ -47,45 +105,45 @@ void Display_status(void)
 	//mugui_lcd_puts(itoa(((void*)&Config.Raw_I_Constrain[P1][0] - (void*)&Config.setup),pBuffer,10),(const unsigned char*)Verdana8,0,0); // 125 - NG (not 121) out by 4
 
 	// Display text
-	LCD_Display_Text(264,(const unsigned char*)Verdana8,0,0); 	// Version text
-	LCD_Display_Text(266,(const unsigned char*)Verdana8,0,12); 	// RX sync
-	LCD_Display_Text(267,(const unsigned char*)Verdana8,0,24); 	// Profile
-	LCD_Display_Text(23,(const unsigned char*)Verdana8,88,24); 	// Pos
-		
+	Status_text(264,(const unsigned char*)Verdana8,0,0); 	// Version text
+	Status_text(266,(const unsigned char*)Verdana8,0,12); 	// RX sync
+	Status_text(267,(const unsigned char*)Verdana8,0,24); 	// Profile
+	Status_text(23,(const unsigned char*)Verdana8,88,24); 	// Pos
+
 	// Display menu and markers
-	LCD_Display_Text(9, (const unsigned char*)Wingdings, 0, 59);// Down
-	LCD_Display_Text(14,(const unsigned char*)Verdana8,10,55);	// Menu
+	Status_text(9, (const unsigned char*)Wingdings, 0, 59);	// Down
+	Status_text(14,(const unsigned char*)Verdana8,10,55);	// Menu
 
 	// Display values
-	print_menu_text(0, 1, (396 + Config.RxMode), 45, 12);		// Rx mode
-	mugui_lcd_puts(itoa(transition,pBuffer,10),(const unsigned char*)Verdana8,110,24); // Raw transition value
+	Status_text((392 + Config.RxMode),(const unsigned char*)Verdana8,45,12); // Rx mode
+	Status_puts(itoa(transition,pBuffer,10),(const unsigned char*)Verdana8,110,24); // Raw transition value
 
 	if (Config.RxMode == PWM)
 	{
-		LCD_Display_Text(24,(const unsigned char*)Verdana8,77,12); // Interrupt counter text 
-		mugui_lcd_puts(itoa(InterruptCount,pBuffer,10),(const unsigned char*)Verdana8,110,12); // Interrupt counter
+		Status_text(24,(const unsigned char*)Verdana8,77,12); // Interrupt counter text
+		Status_puts(itoa(InterruptCount,pBuffer,10),(const unsigned char*)Verdana8,110,12); // Interrupt counter
 	}
 
 	// Display transition point
 	if (transition <= 0)
 	{
-		LCD_Display_Text(48,(const unsigned char*)Verdana8,45,24);
+		Status_text(48,(const unsigned char*)Verdana8,45,24);
 	}
 	else if (transition >= 100)
 	{
-		LCD_Display_Text(50,(const unsigned char*)Verdana8,45,24);
+		Status_text(50,(const unsigned char*)Verdana8,45,24);
 	}
 	else if (transition == Config.Transition_P1n)
 	{
-		LCD_Display_Text(49,(const unsigned char*)Verdana8,45,24);
+		Status_text(49,(const unsigned char*)Verdana8,45,24);
 	}
 	else if (transition < Config.Transition_P1n)
 	{
-		LCD_Display_Text(51,(const unsigned char*)Verdana8,45,24);
+		Status_text(51,(const unsigned char*)Verdana8,45,24);
 	}
 	else
 	{
-		LCD_Display_Text(52,(const unsigned char*)Verdana8,45,24);
+		Status_text(52,(const unsigned char*)Verdana8,45,24);
 	}
 
 	// Don't display battery text if there are error messages
@@ -95,17 +153,17 @@ void Display_status(void)
 		uint8_t x_loc = 45;		// X location of voltage display
 		uint8_t y_loc = 36;		// Y location of voltage display
 
-		LCD_Display_Text(289,(const unsigned char*)Verdana8,0,36); 	// Battery
+		Status_text(289,(const unsigned char*)Verdana8,0,36); 	// Battery
 
 		vbat_temp = GetVbat();
 		temp = vbat_temp/100;	// Display whole decimal part first
 		mugui_text_sizestring(itoa(temp,pBuffer,10), (const unsigned char*)Verdana8, &size);
-		mugui_lcd_puts(itoa(temp,pBuffer,10),(const unsigned char*)Verdana8,x_loc,y_loc);
+		Status_puts(itoa(temp,pBuffer,10),(const unsigned char*)Verdana8,x_loc,y_loc);
 		pos1 = size.x;
 
 		vbat_temp = vbat_temp - (temp * 100); // Now display the parts to the right of the decimal point
 
-		LCD_Display_Text(268,(const unsigned char*)Verdana8,(x_loc + pos1),y_loc);
+		Status_text(268,(const unsigned char*)Verdana8,(x_loc + pos1),y_loc);
 		mugui_text_sizestring(".", (const unsigned char*)Verdana8, &size);
 		pos3 = size.x;
 		mugui_text_sizestring("0", (const unsigned char*)Verdana8, &size);
@@ -113,59 +171,273 @@ void Display_status(void)
 
 		if (vbat_temp >= 10)
 		{
-			mugui_lcd_puts(itoa(vbat_temp,pBuffer,10),(const unsigned char*)Verdana8,(x_loc + pos1 + pos3),y_loc);
+			Status_puts(itoa(vbat_temp,pBuffer,10),(const unsigned char*)Verdana8,(x_loc + pos1 + pos3),y_loc);
 		}
 		else
 		{
-			LCD_Display_Text(269,(const unsigned char*)Verdana8,(x_loc + pos1 + pos3),y_loc);
-			mugui_lcd_puts(itoa(vbat_temp,pBuffer,10),(const unsigned char*)Verdana8,(x_loc + pos1 + pos2 + pos3),y_loc);
+			Status_text(269,(const unsigned char*)Verdana8,(x_loc + pos1 + pos3),y_loc);
+			Status_puts(itoa(vbat_temp,pBuffer,10),(const unsigned char*)Verdana8,(x_loc + pos1 + pos2 + pos3),y_loc);
 		}
-	
-		// Display vibration info is set to "ON"
-		if (Config.Vibration == ON)
-		{
-			// Create message box
-			fillrect(buffer, 29,11, 70, 42, 0);		// White box
-			drawrect(buffer, 29,11, 70, 42, 1); 	// Outline
-
-			// Display vibration data
-			temp = (int16_t)GyroAvgNoise;
-			
-			// Work out pixel size of number to display
-			mugui_text_sizestring(itoa(temp,pBuffer,10), (const unsigned char*)Verdana22, &size);
-			
-			// Center the number in the box automatically
-			mugui_lcd_puts(itoa(temp,pBuffer,10),(const unsigned char*)Verdana22,64 - (size.x / 2),20);
-			
-		} // if (Config.Vibration == ON)	
-	}
-	
+	}
+
 	// Display error messages
 	else
 	{
 		// Prioritise error from top to bottom
 		if(General_error & (1 << LVA_ALARM))
 		{
-			LCD_Display_Text(134,(const unsigned char*)Verdana14,15,37);	// Battery
-			LCD_Display_Text(271,(const unsigned char*)Verdana14,79,37);	// low
+			Status_text(134,(const unsigned char*)Verdana14,15,37);	// Battery
+			Status_text(271,(const unsigned char*)Verdana14,79,37);	// low
 		}
 		else if(General_error & (1 << NO_SIGNAL))
 		{
-			LCD_Display_Text(75,(const unsigned char*)Verdana14,30,37); 	// No
-			LCD_Display_Text(272,(const unsigned char*)Verdana14,55,37);	// signal
+			Status_text(75,(const unsigned char*)Verdana14,30,37); 	// No
+			Status_text(272,(const unsigned char*)Verdana14,55,37);	// signal
 		}
 		else if(General_error & (1 << THROTTLE_HIGH))
 		{
-			LCD_Display_Text(105,(const unsigned char*)Verdana14,11,37);	// Throttle
-			LCD_Display_Text(270,(const unsigned char*)Verdana14,82,37);	// high
+			Status_text(105,(const unsigned char*)Verdana14,11,37);	// Throttle
+			Status_text(270,(const unsigned char*)Verdana14,82,37);	// high
 		}
 		else if(General_error & (1 << DISARMED))
 		{
-			LCD_Display_Text(18,(const unsigned char*)Verdana14,25,37); 	// Disarmed
+			Status_text(18,(const unsigned char*)Verdana14,25,37); 	// Disarmed
+		}
+	}
+
+	// Display vibration info is set to "ON"
+	// Don't display it if there are error messages
+	if ((General_error == 0) && (Config.Vibration == ON))
+	{
+		// Create message box
+		Status_fill(29, 11, 70, 42, 0);		// White box
+
+		Status_fill(29, 11, 70, 1, 1); 		// Outline
+		Status_fill(29, 52, 70, 1, 1);
+		Status_fill(29, 11, 1, 42, 1);
+		Status_fill(98, 11, 1, 42, 1);
+
+		// Display vibration data
+		temp = (int16_t)GyroAvgNoise;
+
+		// Work out pixel size of number to display
+		mugui_text_sizestring(itoa(temp,pBuffer,10), (const unsigned char*)Verdana22, &size);
+
+		// Center the number in the box automatically
+		Status_puts(itoa(temp,pBuffer,10),(const unsigned char*)Verdana22,64 - (size.x / 2),20);
+	}
+}
+
+// RC link statistics page of the status screen
+void Display_rx_stats(void)
+{
+	uint16_t latency[LATENCY_BINS];
+	uint16_t max = 1;
+	uint8_t height, i;
+
+	Status_start();
+
+	// Display text
+	Status_text(486,(const unsigned char*)Verdana8,0,0); 	// Frames
+	Status_text(487,(const unsigned char*)Verdana8,0,12); 	// Bad CRC
+	Status_text(488,(const unsigned char*)Verdana8,80,12); 	// Lost
+	Status_text(489,(const unsigned char*)Verdana8,0,24); 	// Errors
+	Status_text(490,(const unsigned char*)Verdana8,80,24); 	// Sync
+	Status_text(491,(const unsigned char*)Verdana8,0,40); 	// Latency
+	Status_text(492,(const unsigned char*)Verdana8,0,52); 	// 2ms/bar
+
+	// Display values
+	Status_puts(utoa(RxStats.frames,pBuffer,10),(const unsigned char*)Verdana8,45,0);
+	Status_puts(utoa(RxStats.bad_crc,pBuffer,10),(const unsigned char*)Verdana8,45,12);
+	Status_puts(utoa(RxStats.frame_lost,pBuffer,10),(const unsigned char*)Verdana8,105,12);
+	Status_puts(utoa(RxStats.uart_errors,pBuffer,10),(const unsigned char*)Verdana8,45,24);
+	Status_puts(utoa(RxStats.sync_loss,pBuffer,10),(const unsigned char*)Verdana8,105,24);
+
+	// Display the detected Spektrum format
+	if (Config.RxMode == SPEKTRUM)
+	{
+		if (SpektrumFormat & SPEKTRUM_RES_KNOWN)
+		{
+			Status_puts(utoa(((SpektrumFormat & SPEKTRUM_2048) ? 2048 : 1024),pBuffer,10),(const unsigned char*)Verdana8,80,0);
+		}
+
+		if (SpektrumFormat & SPEKTRUM_RATE_KNOWN)
+		{
+			Status_text(((SpektrumFormat & SPEKTRUM_11MS) ? 493 : 494),(const unsigned char*)Verdana8,105,0); // 11ms/22ms
+		}
+	}
+
+	// Take a copy of the latency histogram and find the largest bin
+	for (i = 0; i < LATENCY_BINS; i++)
+	{
+		latency[i] = RxStats.latency[i];
+
+		if (latency[i] > max)
+		{
+			max = latency[i];
+		}
+	}
+
+	// Draw the latency histogram as bars up to 26 pixels high
+	for (i = 0; i < LATENCY_BINS; i++)
+	{
+		height = ((uint32_t)latency[i] * 26) / max;
+		Status_fill(48 + (i * 10), 63 - height, 8, height, 1);
+	}
+
+	Status_fill(46, 63, (LCDWIDTH - 46), 1, 1);				// Baseline
+}
+
+// Draw the next part of the status page. Units of up to STATUS_UNIT_PIXELS are drawn
+// until STATUS_DRAW_TICKS have passed, so each call takes about 0.3ms at most.
+// Returns true once the page is finished and queued for the LCD.
+bool Draw_status(void)
+{
+	uint8_t start = TCNT2;
+
+	do
+	{
+		if (StatusItem >= StatusCount)
+		{
+			// Queue the changes to be streamed to the LCD from the main loop
+			queue_buffer(buffer);
+			return true;
+		}
+
+		if (Draw_status_unit(&StatusItems[StatusItem]))
+		{
+			StatusItem++;
+			StatusChar = 0;
+			StatusPart = 0;
+			StatusXpos = 0;
 		}
 	}
+	while ((uint8_t)(TCNT2 - start) < STATUS_DRAW_TICKS);
+
+	return false;
+}
+
+// Draw one unit of an item. Returns true when the item is finished.
+bool Draw_status_unit(status_item_t* item)
+{
+	uint8_t	c, count, width;
+
+	switch(item->type)
+	{
+		// One page of the buffer
+		case STATUS_CLEAR:
+			memset(&buffer[StatusPart * LCDWIDTH], 0, LCDWIDTH);
+			StatusPart++;
+			return (StatusPart >= (LCDHEIGHT / 8));
+
+		// A band of rows
+		case STATUS_FILL:
+			count = STATUS_UNIT_PIXELS / item->rect.w;
+
+			if (count == 0)
+			{
+				count = 1;
+			}
+
+			if (count > (item->rect.h - StatusPart))
+			{
+				count = item->rect.h - StatusPart;
+			}
+
+			fillrect(buffer, item->x, (item->y + StatusPart), item->rect.w, count, item->rect.colour);
+			StatusPart += count;
+			return (StatusPart >= item->rect.h);
+
+		// A few columns of one character
+		default:
+			if (item->type == STATUS_PGM)
+			{
+				c = pgm_read_byte(&item->pgm[StatusChar]);
+			}
+			else
+			{
+				c = item->ram[StatusChar];
+			}
+
+			if (c == 0)
+			{
+				return true;
+			}
+
+			count = STATUS_UNIT_PIXELS / pgm_read_byte(&item->font[4]); // Font height
+
+			width = mugui_lcd_putc_cols(c, item->font, (item->x + StatusXpos), item->y, StatusPart, count);
+			StatusPart += count;
+
+			// Move on to the next character, one pixel on as for mugui_lcd_puts()
+			if (StatusPart >= width)
+			{
+				StatusXpos += width + 1;
+				StatusChar++;
+				StatusPart = 0;
+			}
+
+			return false;
+	}
+}
 
-	// Write buffer to complete
-	write_buffer(buffer);
-	clear_buffer(buffer);
+// Start a new list, beginning with clearing the buffer
+void Status_start(void)
+{
+	StatusItems[0].type = STATUS_CLEAR;
+	StatusCount = 1;
+	StatusItem = 0;
+	StatusChar = 0;
+	StatusPart = 0;
+	StatusXpos = 0;
+}
+
+// Add the text of "menuitem" to the list
+void Status_text(uint16_t menuitem, const unsigned char* font, uint8_t x, uint8_t y)
+{
+	status_item_t* item = &StatusItems[StatusCount];
+
+	if (StatusCount < STATUS_ITEMS)
+	{
+		item->type = STATUS_PGM;
+		item->x = x;
+		item->y = y;
+		item->font = font;
+		item->pgm = (const char*)pgm_read_word(&text_menu[menuitem]);
+		StatusCount++;
+	}
+}
+
+// Add a copy of the number in "s" to the list
+void Status_puts(char* s, const unsigned char* font, uint8_t x, uint8_t y)
+{
+	status_item_t* item = &StatusItems[StatusCount];
+
+	if (StatusCount < STATUS_ITEMS)
+	{
+		item->type = STATUS_RAM;
+		item->x = x;
+		item->y = y;
+		item->font = font;
+		strncpy(item->ram, s, (STATUS_TEXT_SIZE - 1));
+		item->ram[STATUS_TEXT_SIZE - 1] = 0;
+		StatusCount++;
+	}
+}
+
+// Add a filled rectangle to the list
+void Status_fill(uint8_t x, uint8_t y, uint8_t w, uint8_t h, uint8_t colour)
+{
+	status_item_t* item = &StatusItems[StatusCount];
+
+	if ((StatusCount < STATUS_ITEMS) && w && h)
+	{
+		item->type = STATUS_FILL;
+		item->x = x;
+		item->y = y;
+		item->rect.w = w;
+		item->rect.h = h;
+		item->rect.colour = colour;
+		StatusCount++;
+	}
 }
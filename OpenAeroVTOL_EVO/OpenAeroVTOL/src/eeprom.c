@@ -9,6 +9,7 @@
 #include "compiledefs.h"
 #include <avr/io.h>
 #include <string.h>
+#include <stddef.h>
 #include <avr/interrupt.h>
 #include <avr/eeprom.h>
 #include <avr/pgmspace.h>
@@ -18,6 +19,7 @@
 #include "mixer.h"
 #include "menu_ext.h"
 #include "MPU6050.h"
+#include "uart.h"
 
 //************************************************************
 // Prototypes
@@ -27,25 +29,65 @@ bool Initial_EEPROM_Config_Load(void);
 void Save_Config_to_EEPROM(void);
 void Set_EEPROM_Default_Config(void);
 void eeprom_write_byte_changed(uint8_t *addr, uint8_t value);
-void eeprom_write_block_changes(uint8_t *src, uint8_t *dest, uint16_t size);
+bool Find_EEPROM_bank(void);
+bool Check_EEPROM_bank(uint16_t bank);
+bool Load_newest_bank(void);
+void Start_bank_save(void);
+uint8_t Get_bank_byte(uint16_t index);
+uint16_t Settings_CRC(void);
 void Update_V1_0_to_V1_1(void);
-void Update_V1_1_to_V1_2(void);
-void Update_V1_2_to_V1_3B1(void);
-void Update_V1_3B1_to_V1_3B14(void);
-void Update_V1_3B14_to_V1_3B15(void);
-void Update_V1_3B15_to_V1_3B17(void);
-void Update_V1_3_to_V1_4B2(void);
-void Update_V1_4B2_to_V1_4B8(void);
+void Convert_V1_1_to_V1_2(void);
+void Convert_V1_2_to_V1_3B1(void);
+void Convert_V1_3B14_to_V1_3B15(void);
+void Convert_V1_3B15_to_V1_3B17(void);
+void Apply_migration(migration_t* step);
 uint8_t convert_filter_V1_0_V1_1(uint8_t);
 uint8_t convert_source_V1_2_V1_3(uint8_t old_source);
 
 void Load_eeprom_preset(uint8_t preset);
+void eeprom_start_write(uint16_t addr, uint8_t value);
+void Init_EEPROM_log(void);
+void Add_EEPROM_log(uint8_t event);
+uint8_t Read_EEPROM_log(int8_t* log, uint8_t length);
+bool Check_model(uint8_t model);
+bool Load_model(uint8_t model);
+bool Save_model(uint8_t model);
+uint16_t Model_address(uint8_t model);
+uint16_t Model_CRC(uint16_t addr, uint8_t length);
+uint16_t Encode_model(uint16_t addr);
+void Put_model_byte(uint16_t addr, uint16_t pos, uint8_t value);
+bool Is_board_data(uint16_t index);
+void Wait_EEPROM_idle(void);
 
 //************************************************************
 // Defines
 //************************************************************
 
-#define EEPROM_DATA_START_POS 0	// Make sure Rolf's signature is over-written for safety
+#define EEPROM_SCAN_BYTES 8		// Most bytes compared per EE_READY interrupt
+#define CONFIG_SAVED_SIZE (sizeof(CONFIG_STRUCT) - sizeof(Config.Upgrade))	// Settings only. The derived values are never saved.
+
+// Config banks. Each is the saved settings, then a generation number (1) and a CRC (2) of both.
+// Saves go to the other bank from the one loaded, so a save cut short leaves the last good copy alone.
+#define BANK_A 0				// Old unbanked layouts are here too. Make sure Rolf's signature is over-written for safety
+#define BANK_B 896				// Room for old layouts of up to 896 bytes in front
+#define BANK_SIZE (CONFIG_SAVED_SIZE + 3)
+#define BANK_CRC_INIT 0xFFFF	// Blank or zeroed eeprom never passes
+
+// Model memories. Two fit in the space after each bank.
+// Each is a signature (1), payload length (1) and CRC (2), then runs of the settings that
+// differ from the defaults, each a skip (1), count (1) and that many bytes of data.
+#define MODEL_SIZE ((BANK_B - BANK_SIZE) / (MODELS / 2))
+#define MODEL_HEADER 4
+#define MODEL_PAYLOAD (MODEL_SIZE - MODEL_HEADER)
+#define MODEL_MERGE 2			// Unchanged bytes worth storing to save starting a new run
+
+// Event log journal
+#define LOG_START (E2END + 1 - 256)	// Event log lives in the top 256 bytes of eeprom
+#define LOG_SLOTS 255			// Records in the ring. Not a multiple of LOG_SEQ_MASK + 1, so the head can always be found.
+#define LOG_QUEUE 4				// Records waiting to be written
+#define LOG_EVENT_MASK 0x07		// Record is sequence number (5 bits), event (3 bits)
+#define LOG_SEQ_MASK 0x1F
+#define LOG_EMPTY 0xFF			// Erased eeprom. Event 7 is never used.
 
 // eePROM signature - change for each eePROM structure change to force factory reset or upgrade
 #define V1_0_SIGNATURE 0x35		// EEPROM signature for V1.0 (V1.0 release)
@@ -58,8 +100,12 @@ void Load_eeprom_preset(uint8_t preset);
 #define V1_4_B2_SIGNATURE 0x42	// EEPROM signature for V1.4 (V1.4 Beta 2-7)
 #define V1_4_B8_SIGNATURE 0x43	// EEPROM signature for V1.4 (V1.4 Beta 8+) (V1.4 release)
 #define V1_5_B3_SIGNATURE 0x44	// EEPROM signature for V1.5 (V1.5 Beta 3+)
+#define V1_6_B1_SIGNATURE 0x45	// EEPROM signature for V1.6 (V1.6 Beta 1)
+#define V1_6_B2_SIGNATURE 0x46	// EEPROM signature for V1.6 (V1.6 Beta 2)
+#define V1_6_B3_SIGNATURE 0x47	// EEPROM signature for V1.6 (V1.6 Beta 3)
+#define V1_6_B4_SIGNATURE 0x48	// EEPROM signature for V1.6 (V1.6 Beta 4+)
 
-#define MAGIC_NUMBER V1_5_B3_SIGNATURE // Set current signature
+#define MAGIC_NUMBER V1_6_B4_SIGNATURE // Set current signature
 
 // eePROM data update locations
 #define RCITEMS_V1_0 41		// RAM location of start of RC items data in V1.0, 1.1 and 1.2
@@ -92,6 +138,7 @@ void Load_eeprom_preset(uint8_t preset);
 #define CHANNEL_V1_3_B15	148	// RAM location of start of Channel data in V1.3 B15
 #define P1_THR_V1_3_B15		153	// RAM location of start of OUT1 P1_throttle_volume data in V1.3 B15
 #define OFFSETS_V1_3_B15	588	// RAM location of start of offset data in V1.3 B15
+#define SOURCES_V1_3_B15	26	// Offset of P1_source_a within each V1.3 B15 channel
 #define LAST_BYTE_V1_3B15	653	// Last used byte for V1.3 B15
 
 // V1.3 B17 (no structure change from B15)
@@ -115,6 +162,36 @@ void Load_eeprom_preset(uint8_t preset);
 #define BUZZER_V1_4B2		170	// BUzzer entry in General
 #define LAST_BYTE_V1_4B8	675	// Last used byte for V1.4 B8
 
+// V1.5 B3
+#define BOARD_ANGLE_V1_5B3	171	// Location of new Config.BoardAngle[] after Config.Buzzer
+#define LAST_BYTE_V1_5B3	675	// Last used byte for V1.5 B3
+
+// V1.6 B1
+#define LAST_BYTE_V1_6B1	678	// Last used byte for V1.6 B1
+#define MAIN_FLAGS_V1_6		515	// RAM location of Main_flags for V1.6 B1 to B3
+
+// V1.6 B2
+#define LAST_BYTE_V1_6B2	692	// Last used byte for V1.6 B2
+
+// V1.6 B3
+#define RCITEMS_V1_6B3		41	// RAM location of start of RC items and flight modes (52 bytes)
+#define GENITEMS_V1_6B3		159	// RAM location of start of General items (15 bytes)
+#define CHANNEL_V1_6B3		174	// RAM location of start of Channel data (8 x 34 bytes, P1_value and P2_value first)
+#define SERVOREV_V1_6B3		446	// RAM location of Servo_reverse[] start, up to AileronPol (72 bytes)
+#define ACCZERO_P2_V1_6B3	539	// RAM location of AccZero_P2[] start, up to the end
+#define LAST_BYTE_V1_6B3	704	// Last used byte for V1.6 B3
+
+// V1.6 B4
+#define RCITEMS_V1_6B4		1	// RAM location of start of RC items and flight modes
+#define GENITEMS_V1_6B4		53	// RAM location of start of General items
+#define CHANNEL_V1_6B4		68	// RAM location of start of Channel data (8 x 30 bytes)
+#define SERVOREV_V1_6B4		308	// RAM location of Servo_reverse[] start
+#define ACCZERO_P2_V1_6B4	380	// RAM location of AccZero_P2[] start
+
+// Defaults for new data, as offsets into MigrationDefaults[]
+#define CURVES_DEFAULT_V1_3B1	0	// Curves (48 bytes)
+#define CH_ORDER_DEFAULT_V1_3B1	48	// Custom channel order (8 bytes)
+
 //************************************************************
 // Code
 //************************************************************
@@ -122,32 +199,769 @@ void Load_eeprom_preset(uint8_t preset);
 const int8_t	JR[MAX_RC_CHANNELS] PROGMEM 	= {0,1,2,3,4,5,6,7}; 	// JR/Spektrum channel sequence (TAERG123)
 const int8_t	FUTABA[MAX_RC_CHANNELS] PROGMEM = {1,2,0,3,4,5,6,7}; 	// Futaba channel sequence (AETRGF12)
 const int8_t	MPX[MAX_RC_CHANNELS] PROGMEM	= {1,2,3,5,0,4,6,7}; 	// Multiplex channel sequence (AER1TG23)
-	
+
+// Data that is new in an upgrade and not simply zero
+const int8_t	MigrationDefaults[] PROGMEM =
+{
+	// V1.3 B1 curves (48)[0]
+	0, 17, 33, 50, 67, 83, 100, THROTTLE,
+	0, 17, 33, 50, 67, 83, 100, THROTTLE,
+	-100, -67, -33, 0, 33, 67, 100, THROTTLE,
+	-100, -67, -33, 0, 33, 67, 100, THROTTLE,
+	-100, -67, -33, 0, 33, 67, 100, NOMIX,
+	-100, -67, -33, 0, 33, 67, 100, NOMIX,
+
+	// V1.3 B1 custom channel order, same as JR (8)[48]
+	0, 1, 2, 3, 4, 5, 6, 7
+};
+
+// Upgrade steps for each old eeprom layout, oldest first.
+// The steps for one layout follow on from each other, so starting at the first step for
+// the layout found in eeprom and running to the end brings it up to date in one pass.
+// NB. Offsets are hard-coded to the layout that each step was written for.
+const migration_t Migrations[] PROGMEM =
+{
+	// V1.0 to V1.1. Channel switches expanded to bytes, RC and General items rearranged.
+	{V1_0_SIGNATURE,	MIG_V1_0,		0, 0, 0},
+
+	// V1.1 to V1.2
+	{V1_1_SIGNATURE,	MIG_V1_1,		0, 0, 0},															// New CF_factor and orientation values
+	{V1_1_SIGNATURE,	MIG_MOVE,		(RUDDERPOL_V1_1 + 1), (RCITEMS_V1_0 + 7), 1},						// AileronPol moves past RudderPol
+	{V1_1_SIGNATURE,	MIG_FILL,		(RCITEMS_V1_0 + 7), OFF, 1},										// New Vibration
+	{V1_1_SIGNATURE,	MIG_FILL,		V1_2_NEWDATA, 0, 43},												// New data at the end
+	{V1_1_SIGNATURE,	MIG_MOVE,		(GENITEMS_V1_0 + 2), (GENITEMS_V1_0 + 1), ((RUDDERPOL_V1_1 + 1) - (GENITEMS_V1_0 + 1))}, // Make room for P1_Reference
+	{V1_1_SIGNATURE,	MIG_FILL,		(GENITEMS_V1_0 + 1), NO_ORIENT, 1},									// New P1_Reference
+
+	// V1.2 to V1.3 B1
+	{V1_2_SIGNATURE,	MIG_V1_2,		0, 0, 0},															// New mixer source numbers
+	{V1_2_SIGNATURE,	MIG_DEFAULT,	CURVES_V1_3B1, CURVES_DEFAULT_V1_3B1, (sizeof(curve_t) * NUMBEROFCURVES)},	// New curves
+	{V1_2_SIGNATURE,	MIG_DEFAULT,	CUSTOM_CH_ORD_V1_3_B1, CH_ORDER_DEFAULT_V1_3B1, MAX_RC_CHANNELS},	// New custom channel order
+
+	// V1.3 B1 to V1.3 B14
+	{V1_3_B1_SIGNATURE,	MIG_MOVE,		(RCITEMS_V1_0 + 7), (RCITEMS_V1_0 + 6), (LAST_BYTE_V1_3B14 - (RCITEMS_V1_0 + 6))}, // Make room for TransitionSpeedIn
+	{V1_3_B1_SIGNATURE,	MIG_MOVE,		(RCITEMS_V1_0 + 6), (RCITEMS_V1_0 + 5), 1},							// TransitionSpeedIn same as TransitionSpeedOut
+
+	// V1.3 B14 to V1.3 B15
+	{V1_3_B14_SIGNATURE, MIG_V1_3B14,	0, 0, 0},															// Smaller channel_t
+	{V1_3_B14_SIGNATURE, MIG_MOVE,		SERVOREV_V1_3B15, SERVOREV_V1_3B14, (LAST_BYTE_V1_3B14 - SERVOREV_V1_3B14)}, // Data after the channels
+	{V1_3_B14_SIGNATURE, MIG_FILL,		OFFSETS_V1_3_B15, 0, (sizeof(curve_t) * MAX_OUTPUTS)},				// New offset curves flat
+	{V1_3_B14_SIGNATURE, MIG_MOVE,		(RCITEMS_V1_0 + 9), (RCITEMS_V1_0 + 7), (LAST_BYTE_V1_3B15 - (RCITEMS_V1_0 + 7))}, // Make room for Transition_P1 and Transition_P2
+	{V1_3_B14_SIGNATURE, MIG_MOVE,		(RCITEMS_V1_0 + 8), (RCITEMS_V1_0 + 9), 1},							// Transition_P1n
+	{V1_3_B14_SIGNATURE, MIG_FILL,		(RCITEMS_V1_0 + 7), 0, 1},											// New Transition_P1
+	{V1_3_B14_SIGNATURE, MIG_FILL,		(RCITEMS_V1_0 + 9), 100, 1},										// New Transition_P2
+
+	// V1.3 B15 to V1.3 B17
+	{V1_3_B15_SIGNATURE, MIG_V1_3B15,	0, 0, 0},															// New mixer source list
+
+	// V1.3 B17 (V1.3 release) to V1.4 B2
+	{V1_3_B17_SIGNATURE, MIG_MOVE,		ELE_POL_V1_4B8, ELE_POL_V1_3, 1},									// ElevatorPol moves to the end
+	{V1_3_B17_SIGNATURE, MIG_FILL,		ELE_POL_V1_3, 20, 1},												// New AccVertFilter
+	{V1_3_B17_SIGNATURE, MIG_MOVE,		POWER_TRIG_V1_4, POWER_TRIG_V1_3, (LAST_BYTE_V1_3B15 - POWER_TRIG_V1_3)}, // Make room from PowerTriggerActual on
+	{V1_3_B17_SIGNATURE, MIG_MOVE,		SERVO_CONS_V1_4B8, SERVO_CONS_V1_3, 24},							// Raw I constraints
+	{V1_3_B17_SIGNATURE, MIG_FILL,		SERVO_CONS_V1_4B8, 0, 32},											// Recalculated anyway
+	{V1_3_B17_SIGNATURE, MIG_MOVE,		SERVO_LIMS_V1_4B8, SERVO_LIMS_V1_3, 24},							// Raw I limits
+	{V1_3_B17_SIGNATURE, MIG_FILL,		SERVO_LIMS_V1_4B8, 0, 32},											// Recalculated anyway
+	{V1_3_B17_SIGNATURE, MIG_MOVE,		P2_PROFILE_V1_4B8, P2_PROFILE_V1_3, (P2_PROFILE_V1_4B8 - P1_PROFILE_V1_4B8)}, // P2 profile
+	{V1_3_B17_SIGNATURE, MIG_FILL,		(P1_PROFILE_V1_4B8 + 17), 40, 1},									// New P1 Z parameters
+	{V1_3_B17_SIGNATURE, MIG_FILL,		(P1_PROFILE_V1_4B8 + 18), 20, 1},
+	{V1_3_B17_SIGNATURE, MIG_FILL,		(P1_PROFILE_V1_4B8 + 19), 10, 1},
+	{V1_3_B17_SIGNATURE, MIG_FILL,		(P2_PROFILE_V1_4B8 + 17), 0, 3},									// New P2 Z parameters
+
+	// V1.4 B2 to V1.4 B8
+	{V1_4_B2_SIGNATURE,	MIG_MOVE,		(BUZZER_V1_4B2 + 1), BUZZER_V1_4B2, (LAST_BYTE_V1_4B2 - BUZZER_V1_4B2)},	// Make room for Buzzer
+	{V1_4_B2_SIGNATURE,	MIG_FILL,		BUZZER_V1_4B2, ON, 1},												// New Buzzer
+
+	// V1.4 B8 and V1.5 B3 to V1.6 B1. Same layout, so V1.4 B8 has no steps of its own.
+	{V1_5_B3_SIGNATURE,	MIG_MOVE,		(BOARD_ANGLE_V1_5B3 + NUMBEROFAXIS), BOARD_ANGLE_V1_5B3, (LAST_BYTE_V1_5B3 - BOARD_ANGLE_V1_5B3 + 1)}, // Make room for BoardAngle[]
+	{V1_5_B3_SIGNATURE,	MIG_FILL,		BOARD_ANGLE_V1_5B3, 0, NUMBEROFAXIS},								// Board square to the model
+
+	// V1.6 B1 to V1.6 B2
+	{V1_6_B1_SIGNATURE,	MIG_FILL,		(LAST_BYTE_V1_6B1 + 1), 0, (LAST_BYTE_V1_6B2 - LAST_BYTE_V1_6B1)},	// New temperature compensation
+	{V1_6_B1_SIGNATURE,	MIG_AND,		MAIN_FLAGS_V1_6, (uint8_t)~(1 << tempco_done), 1},					// Not learned yet
+
+	// V1.6 B2 to V1.6 B3
+	{V1_6_B2_SIGNATURE,	MIG_FILL,		(LAST_BYTE_V1_6B2 + 1), 0, (LAST_BYTE_V1_6B3 - LAST_BYTE_V1_6B2)},	// New six-position acc calibration
+	{V1_6_B2_SIGNATURE,	MIG_AND,		MAIN_FLAGS_V1_6, (uint8_t)~(1 << acc_6pos_done), 1},				// Keep using the acc zeros until done
+
+	// V1.6 B3 to V1.6 B4. Derived values no longer saved, so pack the settings up behind the signature.
+	{V1_6_B3_SIGNATURE,	MIG_MOVE,		RCITEMS_V1_6B4, RCITEMS_V1_6B3, 52},								// RC items and flight modes
+	{V1_6_B3_SIGNATURE,	MIG_MOVE,		GENITEMS_V1_6B4, GENITEMS_V1_6B3, 15},								// General items
+	{V1_6_B3_SIGNATURE,	MIG_MOVE,		(CHANNEL_V1_6B4 + (0 * 30)), (CHANNEL_V1_6B3 + 4 + (0 * 34)), 30},	// Channels without P1_value and P2_value
+	{V1_6_B3_SIGNATURE,	MIG_MOVE,		(CHANNEL_V1_6B4 + (1 * 30)), (CHANNEL_V1_6B3 + 4 + (1 * 34)), 30},
+	{V1_6_B3_SIGNATURE,	MIG_MOVE,		(CHANNEL_V1_6B4 + (2 * 30)), (CHANNEL_V1_6B3 + 4 + (2 * 34)), 30},
+	{V1_6_B3_SIGNATURE,	MIG_MOVE,		(CHANNEL_V1_6B4 + (3 * 30)), (CHANNEL_V1_6B3 + 4 + (3 * 34)), 30},
+	{V1_6_B3_SIGNATURE,	MIG_MOVE,		(CHANNEL_V1_6B4 + (4 * 30)), (CHANNEL_V1_6B3 + 4 + (4 * 34)), 30},
+	{V1_6_B3_SIGNATURE,	MIG_MOVE,		(CHANNEL_V1_6B4 + (5 * 30)), (CHANNEL_V1_6B3 + 4 + (5 * 34)), 30},
+	{V1_6_B3_SIGNATURE,	MIG_MOVE,		(CHANNEL_V1_6B4 + (6 * 30)), (CHANNEL_V1_6B3 + 4 + (6 * 34)), 30},
+	{V1_6_B3_SIGNATURE,	MIG_MOVE,		(CHANNEL_V1_6B4 + (7 * 30)), (CHANNEL_V1_6B3 + 4 + (7 * 34)), 30},
+	{V1_6_B3_SIGNATURE,	MIG_MOVE,		SERVOREV_V1_6B4, SERVOREV_V1_6B3, 72},								// Servo_reverse[] to AileronPol
+	{V1_6_B3_SIGNATURE,	MIG_MOVE,		ACCZERO_P2_V1_6B4, ACCZERO_P2_V1_6B3, (LAST_BYTE_V1_6B3 - ACCZERO_P2_V1_6B3 + 1)}, // AccZero_P2[] to the end
+};
+
+#define MIGRATION_STEPS (sizeof(Migrations) / sizeof(migration_t))
+
+// Settings that belong to the board rather than the model, as [start, end) offsets.
+// Loading a model leaves these as they are.
+const uint16_t BoardData[][2] PROGMEM = 
+{
+	{offsetof(CONFIG_STRUCT, Contrast),				offsetof(CONFIG_STRUCT, ArmMode)},			// LCD contrast
+	{offsetof(CONFIG_STRUCT, RxChannelZeroOffset),	offsetof(CONFIG_STRUCT, FlightSel)},		// RC offsets, P1 sensor and airspeed zeros
+	{offsetof(CONFIG_STRUCT, Main_flags),			offsetof(CONFIG_STRUCT, RudderPol)},		// Calibration flags
+	{offsetof(CONFIG_STRUCT, AccZero_P2),			offsetof(CONFIG_STRUCT, Orientation_P1)},	// P2 sensor zeros
+	{offsetof(CONFIG_STRUCT, TempRef),				offsetof(CONFIG_STRUCT, Derived)},			// Temperature and six-position acc calibration
+};
+
+#define BOARD_RANGES (sizeof(BoardData) / sizeof(BoardData[0]))
+
+volatile bool EEPROM_save_pending = false;	// True until the background save has finished
+volatile uint16_t EEPROM_save_index = 0;	// Next byte of the bank to compare
+
+uint16_t ActiveBank = BANK_A;				// Bank that the settings were last loaded from or saved to
+uint8_t ActiveGen = 0;						// Its generation number
+uint16_t ActiveCRC = BANK_CRC_INIT;			// Its CRC
+uint16_t SaveBank = BANK_B;					// Bank being saved to
+uint8_t SaveGen = 0;						// Generation number being saved
+uint16_t SaveCRC = BANK_CRC_INIT;			// CRC of the bank so far
+
+uint8_t LogHead = 0;						// Next journal slot to use
+uint8_t LogSeq = 0;							// Next journal sequence number
+volatile uint8_t LogWritten = 0;			// Next journal slot to be written to eeprom
+uint8_t LogQueue[LOG_QUEUE];				// Records waiting for the eeprom, by slot
+
+//************************************************************
+// Save Config to eeprom
+//
+// Each changed byte takes about 3.4ms to program, so the save runs
+// in the background from the EE_READY interrupt, one byte at a time.
+// Calling this again while a save is running restarts it from the
+// first byte, so that later changes are not missed.
+//
+// The save goes to the inactive bank and its generation and CRC are
+// written last, so the bank only takes over once it is complete.
+// Settings that match the active bank are not saved again, so the
+// calls at start-up and on leaving a menu cost nothing if unchanged.
+//************************************************************
+
 void Save_Config_to_EEPROM(void)
 {
-	// Write to eeProm
+	uint16_t crc = Settings_CRC();
+	uint16_t i;
+	uint8_t	sreg = SREG;
+
+	// Nothing changed since the active bank was loaded or saved. A save still
+	// running may hold older settings, so that is restarted as usual.
+	cli();
+	if ((crc == ActiveCRC) && !EEPROM_save_pending)
+	{
+		SREG = sreg;
+		return;
+	}
+	SREG = sreg;
+
+	// The queue can't run with interrupts off (e.g. during start-up), so write it all now
+	if (!(SREG & (1 << SREG_I)))
+	{
+		Start_bank_save();
+
+		for (i = 0; i < BANK_SIZE; i++)
+		{
+			eeprom_write_byte_changed((uint8_t*)(SaveBank + i), Get_bank_byte(i));
+		}
+
+		ActiveBank = SaveBank;
+		ActiveGen = SaveGen;
+		ActiveCRC = SaveCRC;
+		EEPROM_save_pending = false;
+		return;
+	}
+
 	cli();
-	eeprom_write_block_changes((uint8_t*)&Config, (uint8_t*)EEPROM_DATA_START_POS, sizeof(CONFIG_STRUCT));	
+	Start_bank_save();
+	EEPROM_save_pending = true;
+	EECR |= (1 << EERIE);					// EE_READY fires as soon as the eeprom is idle
 	sei();
 }
 
-// src is the address in RAM
-// dest is the address in eeprom
-void eeprom_write_block_changes(uint8_t *src, uint8_t *dest, uint16_t size)
-{ 
-	uint16_t len;
+// Set up a save to the bank that isn't active
+void Start_bank_save(void)
+{
+	if (ActiveBank == BANK_A)
+	{
+		SaveBank = BANK_B;
+	}
+	else
+	{
+		SaveBank = BANK_A;
+	}
+
+	SaveGen = ActiveGen + 1;
+	SaveCRC = BANK_CRC_INIT;
+	EEPROM_save_index = 0;
+}
+
+// Byte number "index" of the bank being saved.
+// Must be called once for each byte in order, as it works out the CRC on the way.
+uint8_t Get_bank_byte(uint16_t index)
+{
 	uint8_t value;
 
-	for (len = 0; len < size; len++)
+	if (index < CONFIG_SAVED_SIZE)
 	{
-		// Get value at src
-		value = *src;
-		
-		// Write the value at src to dest
-		eeprom_write_byte_changed(dest, value);
-		src++;
-		dest++;
+		value = ((uint8_t*)&Config)[index];
+	}
+	else if (index == CONFIG_SAVED_SIZE)
+	{
+		value = SaveGen;
+	}
+	else if (index == (CONFIG_SAVED_SIZE + 1))
+	{
+		return (uint8_t)SaveCRC;
+	}
+	else
+	{
+		return (uint8_t)(SaveCRC >> 8);
+	}
+
+	SaveCRC = CRC16(SaveCRC, value);
+
+	return value;
+}
+
+// CRC the active bank would have if it held the settings in RAM
+uint16_t Settings_CRC(void)
+{
+	uint16_t crc = BANK_CRC_INIT;
+	uint16_t i;
+
+	for (i = 0; i < CONFIG_SAVED_SIZE; i++)
+	{
+		crc = CRC16(crc, ((uint8_t*)&Config)[i]);
+	}
+
+	return CRC16(crc, ActiveGen);
+}
+
+ISR(EE_READY_vect)
+{
+	uint8_t	value;
+	uint8_t	i;
+
+	// Log records go first. They are single bytes and always need writing.
+	if (LogWritten != LogHead)
+	{
+		eeprom_start_write((LOG_START + LogWritten), LogQueue[LogWritten % LOG_QUEUE]);
+
+		LogWritten++;
+
+		if (LogWritten >= LOG_SLOTS)
+		{
+			LogWritten = 0;
+		}
+
+		return;
+	}
+
+	// Only compare a few bytes per interrupt to keep the latency down for the RC and timer interrupts
+	for (i = 0; (i < EEPROM_SCAN_BYTES) && EEPROM_save_pending; i++)
+	{
+		// All done. The new bank is now the one to load.
+		if (EEPROM_save_index >= BANK_SIZE)
+		{
+			ActiveBank = SaveBank;
+			ActiveGen = SaveGen;
+			ActiveCRC = SaveCRC;
+			EEPROM_save_pending = false;
+			break;
+		}
+
+		value = Get_bank_byte(EEPROM_save_index);
+
+		// Read the eeprom copy
+		EEAR = SaveBank + EEPROM_save_index;
+		EECR |= (1 << EERE);
+
+		if (EEDR != value)
+		{
+			eeprom_start_write((SaveBank + EEPROM_save_index), value);
+
+			// EE_READY fires again when the byte is done
+			EEPROM_save_index++;
+			return;
+		}
+
+		EEPROM_save_index++;
+	}
+
+	// Nothing left to do
+	if (!EEPROM_save_pending)
+	{
+		EECR &= ~(1 << EERIE);
+	}
+}
+
+// Start programming one byte. Only call with interrupts off and the eeprom idle.
+void eeprom_start_write(uint16_t addr, uint8_t value)
+{
+	EEAR = addr;
+	EEDR = value;
+
+	// EEPE must follow EEMPE within four cycles
+	EECR |= (1 << EEMPE);
+	EECR |= (1 << EEPE);
+}
+
+//************************************************************
+// Event log journal
+//
+// Events are kept in their own ring of single-byte records at the
+// top of the eeprom, so logging never rewrites the config and the
+// wear is spread over the whole ring. Each record holds a 5-bit 
+// sequence number, so the newest record is the one where the 
+// sequence breaks. A NOERR record marks where the log was cleared.
+//************************************************************
+
+// Find the head of the journal. Called at start-up with interrupts off.
+void Init_EEPROM_log(void)
+{
+	uint8_t	record, next;
+	uint8_t	i;
+
+	LogHead = 0;
+	LogSeq = 0;
+
+	for (i = 0; i < LOG_SLOTS; i++)
+	{
+		record = eeprom_read_byte((uint8_t*)(LOG_START + i));
+
+		// First empty slot after the records written so far
+		if (record == LOG_EMPTY)
+		{
+			break;
+		}
+
+		LogHead = i + 1;
+		LogSeq = ((record >> 3) + 1) & LOG_SEQ_MASK;
+
+		// When the ring is full, the newest record is followed by one out of sequence
+		if (i < (LOG_SLOTS - 1))
+		{
+			next = eeprom_read_byte((uint8_t*)(LOG_START + i + 1));
+
+			if ((next != LOG_EMPTY) && ((next >> 3) != LogSeq))
+			{
+				break;
+			}
+		}
+	}
+
+	if (LogHead >= LOG_SLOTS)
+	{
+		LogHead = 0;
+	}
+
+	LogWritten = LogHead;
+}
+
+// Queue one record. It is dropped if the queue is full.
+void Add_EEPROM_log(uint8_t event)
+{
+	uint8_t	next = LogHead + 1;
+	uint8_t	queued;
+	uint8_t	sreg = SREG;
+
+	if (next >= LOG_SLOTS)
+	{
+		next = 0;
+	}
+
+	cli();
+
+	queued = (LogHead >= LogWritten) ? (LogHead - LogWritten) : (LogHead + LOG_SLOTS - LogWritten);
+
+	if (queued < (LOG_QUEUE - 1))
+	{
+		LogQueue[LogHead % LOG_QUEUE] = (LogSeq << 3) | (event & LOG_EVENT_MASK);
+		LogSeq = (LogSeq + 1) & LOG_SEQ_MASK;
+		LogHead = next;
+
+		// EE_READY writes it as soon as the eeprom is idle
+		EECR |= (1 << EERIE);
+	}
+
+	SREG = sreg;
+}
+
+// Copy up to (length) of the newest events since the log was last cleared 
+// into log[], oldest first. Returns the number of events.
+uint8_t Read_EEPROM_log(int8_t* log, uint8_t length)
+{
+	uint8_t	slot = LogHead;
+	uint8_t	count = 0;
+	uint8_t	record;
+	uint8_t	sreg = SREG;
+
+	memset(log, 0, length);
+
+	// Keep the EE_READY interrupt off the eeprom registers
+	cli();
+
+	while (count < length)
+	{
+		slot = (slot == 0) ? (LOG_SLOTS - 1) : (slot - 1);
+
+		// Not written yet, so still in the queue
+		if (((LogHead >= LogWritten) && (slot >= LogWritten) && (slot < LogHead)) ||
+			((LogHead < LogWritten) && ((slot >= LogWritten) || (slot < LogHead))))
+		{
+			record = LogQueue[slot % LOG_QUEUE];
+		}
+		else
+		{
+			record = eeprom_read_byte((uint8_t*)(LOG_START + slot));
+		}
+
+		// Stop at the clear marker, empty eeprom or once round the ring
+		if ((record == LOG_EMPTY) || ((record & LOG_EVENT_MASK) == NOERR) || (slot == LogHead))
+		{
+			break;
+		}
+
+		count++;
+		log[length - count] = record & LOG_EVENT_MASK;
+	}
+
+	SREG = sreg;
+
+	// Move to the start of log[]
+	if (count < length)
+	{
+		memmove(log, &log[length - count], count);
+		memset(&log[count], 0, (length - count));
+	}
+
+	return count;
+}
+
+//************************************************************
+// Model memories
+//
+// A model is stored as the differences between its settings and
+// the factory defaults, so most models take a fraction of the space
+// of a full bank. The mixer presets in Load_eeprom_preset() remain
+// the templates kept in flash. Board data is not part of a model.
+//
+// Loading a model only touches RAM, so it is ready to fly as soon 
+// as UpdateLimits() has run. The changed bytes then go to the 
+// config bank in the background as for any other change.
+//************************************************************
+
+// Eeprom address of a model memory
+uint16_t Model_address(uint8_t model)
+{
+	uint16_t bank = (model < (MODELS / 2)) ? BANK_A : BANK_B;
+
+	return (bank + BANK_SIZE + ((model % (MODELS / 2)) * MODEL_SIZE));
+}
+
+// True if the model memory holds a model saved with the current layout
+bool Check_model(uint8_t model)
+{
+	uint16_t addr = Model_address(model);
+	uint8_t	length;
+	bool	good = false;
+	uint8_t	sreg = SREG;
+
+	// Keep the EE_READY interrupt off the eeprom registers
+	cli();
+
+	length = eeprom_read_byte((uint8_t*)(addr + 1));
+
+	if ((eeprom_read_byte((uint8_t*)addr) == MAGIC_NUMBER) && (length <= MODEL_PAYLOAD))
+	{
+		good = (Model_CRC(addr, length) == eeprom_read_word((uint16_t*)(addr + 2)));
+	}
+
+	SREG = sreg;
+
+	return good;
+}
+
+// Replace the settings with a saved model. Returns false if the memory is empty.
+// Call UpdateLimits() afterwards.
+bool Load_model(uint8_t model)
+{
+	uint16_t addr = Model_address(model) + MODEL_HEADER;
+	uint16_t index = 1;
+	uint16_t pos = 0;
+	uint16_t start;
+	uint8_t	length, count;
+	uint8_t	i;
+
+	if (!Check_model(model))
+	{
+		return false;
+	}
+
+	// The board data is read back from the active bank, so it must be up to date
+	Wait_EEPROM_idle();
+
+	length = eeprom_read_byte((uint8_t*)(addr - MODEL_HEADER + 1));
+
+	// The derived values are left alone until UpdateLimits(), so the interrupts can stay on.
+	// Only the menu calls this, so the outputs don't use the part built settings.
+	Set_EEPROM_Default_Config();
+
+	// Apply each run of changes
+	while ((pos + 1) < length)
+	{
+		index += eeprom_read_byte((uint8_t*)(addr + pos));
+		count = eeprom_read_byte((uint8_t*)(addr + pos + 1));
+		pos += 2;
+
+		if ((index + count) > CONFIG_SAVED_SIZE)
+		{
+			break;
+		}
+
+		eeprom_read_block((void*)((&Config.setup) + index), (const void*)(addr + pos), count);
+
+		index += count;
+		pos += count;
 	}
+
+	// Put back the board data
+	for (i = 0; i < BOARD_RANGES; i++)
+	{
+		start = pgm_read_word(&BoardData[i][0]);
+		eeprom_read_block((void*)((&Config.setup) + start), (const void*)(ActiveBank + start), (pgm_read_word(&BoardData[i][1]) - start));
+	}
+
+	return true;
+}
+
+// Save the current settings as a model. Returns false if they don't fit.
+// The settings and derived values are left as they were.
+bool Save_model(uint8_t model)
+{
+	uint16_t addr = Model_address(model);
+	uint16_t length;
+	uint16_t crc;
+
+	// The settings are compared from the active bank, so it must be up to date
+	Wait_EEPROM_idle();
+
+	// The settings hold the defaults while the differences are worked out. The derived
+	// values are untouched and only the menu calls this, so the interrupts stay on while
+	// the changed model bytes are written.
+	Set_EEPROM_Default_Config();
+
+	length = Encode_model(0);
+
+	if (length <= MODEL_PAYLOAD)
+	{
+		// The signature goes last, so a save cut short leaves the memory empty
+		eeprom_write_byte_changed((uint8_t*)addr, 0xFF);
+		Encode_model(addr);
+		eeprom_write_byte_changed((uint8_t*)(addr + 1), (uint8_t)length);
+		crc = Model_CRC(addr, (uint8_t)length);
+		eeprom_write_byte_changed((uint8_t*)(addr + 2), (uint8_t)crc);
+		eeprom_write_byte_changed((uint8_t*)(addr + 3), (uint8_t)(crc >> 8));
+		eeprom_write_byte_changed((uint8_t*)addr, MAGIC_NUMBER);
+	}
+
+	// Back to the current settings
+	eeprom_read_block((void*)&Config, (const void*)ActiveBank, CONFIG_SAVED_SIZE);
+
+	return (length <= MODEL_PAYLOAD);
+}
+
+// Write the differences between the active bank and the defaults in RAM
+// as the payload of the model at "addr". An addr of zero just measures them.
+// Returns the payload length, which can be more than fits.
+uint16_t Encode_model(uint16_t addr)
+{
+	uint16_t length = 0;
+	uint16_t count_pos = 0;		// Payload position of the count for the open run
+	uint16_t gap = 0;			// Unchanged bytes since the last changed one
+	uint16_t i, j;
+	uint8_t	count = 0;			// Bytes in the open run
+	uint8_t	value;
+
+	// The signature is never part of a model
+	for (i = 1; i < CONFIG_SAVED_SIZE; i++)
+	{
+		value = eeprom_read_byte((uint8_t*)(ActiveBank + i));
+
+		if ((value == ((uint8_t*)&Config)[i]) || Is_board_data(i))
+		{
+			gap++;
+			continue;
+		}
+
+		// A short gap costs less to store than starting a new run
+		if (count && (gap <= MODEL_MERGE) && ((count + gap) < 255))
+		{
+			for (j = (i - gap); j < i; j++)
+			{
+				Put_model_byte(addr, length++, eeprom_read_byte((uint8_t*)(ActiveBank + j)));
+			}
+
+			count += gap;
+		}
+		else
+		{
+			if (count)
+			{
+				Put_model_byte(addr, count_pos, count);
+			}
+
+			// Skips longer than a byte need empty runs
+			while (gap > 255)
+			{
+				Put_model_byte(addr, length++, 255);
+				Put_model_byte(addr, length++, 0);
+				gap -= 255;
+			}
+
+			Put_model_byte(addr, length++, (uint8_t)gap);
+			count_pos = length++;
+			count = 0;
+		}
+
+		Put_model_byte(addr, length++, value);
+		count++;
+		gap = 0;
+	}
+
+	if (count)
+	{
+		Put_model_byte(addr, count_pos, count);
+	}
+
+	return length;
+}
+
+// Write one payload byte of the model at "addr", if there is room
+void Put_model_byte(uint16_t addr, uint16_t pos, uint8_t value)
+{
+	if (addr && (pos < MODEL_PAYLOAD))
+	{
+		eeprom_write_byte_changed((uint8_t*)(addr + MODEL_HEADER + pos), value);
+	}
+}
+
+// CRC of a model's signature, length and payload
+uint16_t Model_CRC(uint16_t addr, uint8_t length)
+{
+	uint16_t crc = BANK_CRC_INIT;
+	uint8_t	i;
+
+	crc = CRC16(crc, MAGIC_NUMBER);
+	crc = CRC16(crc, length);
+
+	for (i = 0; i < length; i++)
+	{
+		crc = CRC16(crc, eeprom_read_byte((uint8_t*)(addr + MODEL_HEADER + i)));
+	}
+
+	return crc;
+}
+
+// True if byte "index" of the settings belongs to the board
+bool Is_board_data(uint16_t index)
+{
+	uint8_t i;
+
+	for (i = 0; i < BOARD_RANGES; i++)
+	{
+		if ((index >= pgm_read_word(&BoardData[i][0])) && (index < pgm_read_word(&BoardData[i][1])))
+		{
+			return true;
+		}
+	}
+
+	return false;
+}
+
+// Wait for the background save and any log records to be written. Needs interrupts on.
+void Wait_EEPROM_idle(void)
+{
+	while (EEPROM_save_pending || (LogWritten != LogHead));
+
+	eeprom_busy_wait();
+}
+
+// Check the CRC of the bank at eeprom address "bank"
+bool Check_EEPROM_bank(uint16_t bank)
+{
+	uint16_t crc = BANK_CRC_INIT;
+	uint16_t i;
+
+	// Settings and generation number
+	for (i = 0; i <= CONFIG_SAVED_SIZE; i++)
+	{
+		crc = CRC16(crc, eeprom_read_byte((uint8_t*)(bank + i)));
+	}
+
+	return (crc == eeprom_read_word((uint16_t*)(bank + CONFIG_SAVED_SIZE + 1)));
+}
+
+// Start-up fast path. Read the newest bank into RAM in one pass and check it there.
+// Returns false if it is bad or an old layout, which leaves the full checks to do.
+bool Load_newest_bank(void)
+{
+	uint8_t	*ram = (uint8_t*)&Config;
+	uint8_t	gen_a = eeprom_read_byte((uint8_t*)(BANK_A + CONFIG_SAVED_SIZE));
+	uint8_t	gen_b = eeprom_read_byte((uint8_t*)(BANK_B + CONFIG_SAVED_SIZE));
+	uint16_t bank = ((int8_t)(gen_b - gen_a) > 0) ? BANK_B : BANK_A;
+	uint16_t crc = BANK_CRC_INIT;
+	uint16_t i;
+
+	// The generation and CRC land at the start of the derived values, which are cleared later
+	eeprom_read_block((void*)&Config, (const void*)bank, BANK_SIZE);
+
+	for (i = 0; i <= CONFIG_SAVED_SIZE; i++)
+	{
+		crc = CRC16(crc, ram[i]);
+	}
+
+	if ((Config.setup != MAGIC_NUMBER) ||
+		(crc != (ram[CONFIG_SAVED_SIZE + 1] | (ram[CONFIG_SAVED_SIZE + 2] << 8))))
+	{
+		return false;
+	}
+
+	ActiveBank = bank;
+	ActiveGen = ram[CONFIG_SAVED_SIZE];
+	ActiveCRC = crc;
+
+	return true;
+}
+
+// Make the newest good bank active. Returns false if neither is good,
+// which leaves bank A, where any old unbanked layout will be.
+bool Find_EEPROM_bank(void)
+{
+	bool	good_a = Check_EEPROM_bank(BANK_A);
+	bool	good_b = Check_EEPROM_bank(BANK_B);
+	uint8_t	gen_a = eeprom_read_byte((uint8_t*)(BANK_A + CONFIG_SAVED_SIZE));
+	uint8_t	gen_b = eeprom_read_byte((uint8_t*)(BANK_B + CONFIG_SAVED_SIZE));
+
+	// Generation numbers wrap, so B is newer if it is less than 128 ahead
+	if (good_b && (!good_a || ((int8_t)(gen_b - gen_a) > 0)))
+	{
+		ActiveBank = BANK_B;
+		ActiveGen = gen_b;
+	}
+	else
+	{
+		ActiveBank = BANK_A;
+		ActiveGen = gen_a;
+	}
+
+	ActiveCRC = eeprom_read_word((uint16_t*)(ActiveBank + CONFIG_SAVED_SIZE + 1));
+
+	return (good_a || good_b);
 }
 
 // addr is the address in eeprom
@@ -163,66 +977,74 @@ void eeprom_write_byte_changed(uint8_t *addr, uint8_t value)
 bool Initial_EEPROM_Config_Load(void)
 {
 	bool updated = false;
+	bool changed;
+	migration_t step;
+	uint8_t i, signature;
 	
-	// Read eeProm data into RAM
-	eeprom_read_block((void*)&Config, (const void*)EEPROM_DATA_START_POS, sizeof(CONFIG_STRUCT));
+	// Normally the last save finished and the layout is current, so nothing more is needed
+	if (Load_newest_bank())
+	{
+		memset(&Config.Derived, 0, sizeof(Config.Upgrade));
+		return false;
+	}
+
+	// Only a good bank can be used as it is. A save cut short just falls back to the other one.
+	changed = !Find_EEPROM_bank();
+
+	// Read eeProm data into RAM. Old layouts can be bigger than the saved settings.
+	eeprom_read_block((void*)&Config, (const void*)ActiveBank, sizeof(CONFIG_STRUCT));
 	
 	// See if we know what to do with the current eeprom data
 	// Config.setup holds the magic number from the current EEPROM
-	switch(Config.setup)
+	if (Config.setup != MAGIC_NUMBER)
 	{
-		case V1_0_SIGNATURE:				// V1.0 detected
-			Update_V1_0_to_V1_1();
-			updated = true;
-			// Fall through...
-
-		case V1_1_SIGNATURE:				// V1.1 detected
-			Update_V1_1_to_V1_2();
-			updated = true;
-			// Fall through...
-
-		case V1_2_SIGNATURE:				// V1.2 detected
-			Update_V1_2_to_V1_3B1();
-			updated = true;
-			// Fall through...
-
-		case V1_3_B1_SIGNATURE:				// V1.3 B1 detected
-			Update_V1_3B1_to_V1_3B14();
-			updated = true;
-			// Fall through...
-
-		case V1_3_B14_SIGNATURE:			// V1.3 B14 detected
-			Update_V1_3B14_to_V1_3B15();
-			updated = true;
-			// Fall through...
-			
-		case V1_3_B15_SIGNATURE:			// V1.3 B15 detected
-			Update_V1_3B15_to_V1_3B17();
-			updated = true;
-			// Fall through...
-
-		case V1_3_B17_SIGNATURE:			// V1.3 B17 (V1.3 release) detected
-			Update_V1_3_to_V1_4B2();
-			updated = true;
-			// Fall through...
-
-		case V1_4_B2_SIGNATURE:				// V1.4 B2-7 detected (V1.4 Beta release)
-			Update_V1_4B2_to_V1_4B8();
-			updated = true;
-			// Fall through...
-
-		case V1_4_B8_SIGNATURE:				// V1.4 B8+ detected
-		case V1_5_B3_SIGNATURE:				// V1.5B3+
-			break;
-			
-		default:							// Unknown solution - restore to factory defaults
-			// Load factory defaults
+		changed = true;
+
+		// Find the first upgrade step for this layout. Signatures are consecutive from V1.3 B1,
+		// so a layout with no steps of its own starts at the steps for the next one.
+		for (i = 0; i < MIGRATION_STEPS; i++)
+		{
+			signature = pgm_read_byte(&Migrations[i].signature);
+
+			if ((signature == Config.setup) || ((signature > Config.setup) && (Config.setup >= V1_3_B1_SIGNATURE)))
+			{
+				updated = true;
+				break;
+			}
+		}
+
+		// Apply it and every later step
+		for (; i < MIGRATION_STEPS; i++)
+		{
+			memcpy_P(&step, &Migrations[i], sizeof(migration_t));
+			Apply_migration(&step);
+		}
+
+		if (updated)
+		{
+			Config.setup = MAGIC_NUMBER;
+		}
+		// Unknown solution - restore to factory defaults
+		else
+		{
 			Set_EEPROM_Default_Config();
-			break;
+		}
+	}
+	// Current layout but neither bank passes its CRC, so the data can't be trusted.
+	// Restore to factory defaults as for a first boot.
+	else if (changed)
+	{
+		Set_EEPROM_Default_Config();
 	}
 	
-	// Save back to eeprom	
-	Save_Config_to_EEPROM();
+	// Whatever was read or upgraded past the settings is not valid until UpdateLimits() runs
+	memset(&Config.Derived, 0, sizeof(Config.Upgrade));
+	
+	// Save back to eeprom if it didn't come straight from a good bank
+	if (changed)
+	{
+		Save_Config_to_EEPROM();
+	}
 	
 	// Return info regarding eeprom structure changes 
 	return updated;
@@ -563,8 +1385,60 @@ void Update_V1_0_to_V1_1(void)
 	memcpy((void*)((&Config.setup) + (RUDDERPOL_V1_1)),(void*)&buffer[9],1);	// RudderPol
 }
 
-// Upgrade V1.1 structure to V1.2
-void Update_V1_1_to_V1_2(void)
+// Apply one upgrade step to the RAM copy of the config
+void Apply_migration(migration_t* step)
+{
+	uint8_t		*dst = (&Config.setup) + step->dst;
+	uint16_t	i;
+
+	switch(step->op)
+	{
+		case MIG_MOVE:
+			memmove((void*)dst, (void*)((&Config.setup) + step->src), step->len);
+			break;
+
+		case MIG_FILL:
+			memset((void*)dst, (uint8_t)step->src, step->len);
+			break;
+
+		case MIG_DEFAULT:
+			memcpy_P((void*)dst, &MigrationDefaults[step->src], step->len);
+			break;
+
+		case MIG_AND:
+			for (i = 0; i < step->len; i++)
+			{
+				dst[i] &= (uint8_t)step->src;
+			}
+			break;
+
+		case MIG_V1_0:
+			Update_V1_0_to_V1_1();
+			break;
+
+		case MIG_V1_1:
+			Convert_V1_1_to_V1_2();
+			break;
+
+		case MIG_V1_2:
+			Convert_V1_2_to_V1_3B1();
+			break;
+
+		case MIG_V1_3B14:
+			Convert_V1_3B14_to_V1_3B15();
+			break;
+
+		case MIG_V1_3B15:
+			Convert_V1_3B15_to_V1_3B17();
+			break;
+
+		default:
+			break;
+	}
+}
+
+// Convert V1.1 CF_factor and orientation values to V1.2
+void Convert_V1_1_to_V1_2(void)
 {
 	int8_t	Orientation_P2 = 0;
 	int8_t	temp = 0;
@@ -604,12 +1478,6 @@ void Update_V1_1_to_V1_2(void)
 	
 	// Write updated Config.CF_factor value
 	memcpy((void*)((&Config.setup) + (ALCORRECT_V1_1)),(void*)&temp,1);
-		
-	// Copy AileronPol from RCitems to its new location
-	memcpy((void*)((&Config.setup) + (RUDDERPOL_V1_1 + 1)),(void*)((&Config.setup) + (RCITEMS_V1_0 + 7)),1);
-	
-	// Set the new Vibe value to OFF
-	memset((void*)((&Config.setup) + (RCITEMS_V1_0 + 7)), OFF, 1);
 
 	// Update the orientation byte to be the P2 orientation
 	memcpy((void*)&Orientation_P2,(void*)((&Config.setup) + (GENITEMS_V1_0)),1);
@@ -640,21 +1508,12 @@ void Update_V1_1_to_V1_2(void)
 			break;	
 	}
 
-	// Clear new data area at end of data											// Log pointer onwards
-	memset((void*)((&Config.setup) + (V1_2_NEWDATA)), 0, 43);
-	
-	// Move everything from Config.Contrast up by one byte to make room for Config.P1_Reference	
-	// AileronPol has already been moved up past RudderPol so we need to add one byte
-	memmove((void*)((&Config.setup) + (GENITEMS_V1_0 + 2)), (void*)((&Config.setup) + (GENITEMS_V1_0 + 1)), ((RUDDERPOL_V1_1 + 1) - (GENITEMS_V1_0 + 1))); // (520 + 1 - 136 + 1 = 386 bytes)
-
 	// Save updated orientation
 	memcpy((void*)((&Config.setup) + (GENITEMS_V1_0 )),(void*)&Orientation_P2,1);	// Updated P2 orientation value
-	memset((void*)((&Config.setup) + (GENITEMS_V1_0 + 1)), NO_ORIENT, 1);			// New P1_Reference
-	
 }
 
-// Upgrade V1.2 structure to V1.3
-void Update_V1_2_to_V1_3B1(void)
+// Convert V1.2 source settings to V1.3 B1
+void Convert_V1_2_to_V1_3B1(void)
 {
 	int8_t i = 0;
 	int8_t source = 0;
@@ -677,71 +1536,14 @@ void Update_V1_2_to_V1_3B1(void)
 		memcpy((void*)&source, (void*)((&Config.setup) + (CHANNEL_V1_3_B1 + 36 + (i * 38))), 1);	// P2_source_b
 		memset((void*)((&Config.setup) + (CHANNEL_V1_3_B1 + 36 + (i * 38))), convert_source_V1_2_V1_3(source), 1);
 	}
-
-	// Set new data to defaults
-	// Curves 0 and 1
-	for (i = 0; i < 2; i++)
-	{
-		memset((void*)((&Config.setup) + (CURVES_V1_3B1 + 0 + (8 * i))), 0, 1);		// Config.Curve[i].Point1
-		memset((void*)((&Config.setup) + (CURVES_V1_3B1 + 1 + (8 * i))), 17, 1);	// Config.Curve[i].Point2
-		memset((void*)((&Config.setup) + (CURVES_V1_3B1 + 2 + (8 * i))), 33, 1);	// Config.Curve[i].Point3
-		memset((void*)((&Config.setup) + (CURVES_V1_3B1 + 3 + (8 * i))), 50, 1);	// Config.Curve[i].Point4
-		memset((void*)((&Config.setup) + (CURVES_V1_3B1 + 4 + (8 * i))), 67, 1);	// Config.Curve[i].Point5
-		memset((void*)((&Config.setup) + (CURVES_V1_3B1 + 5 + (8 * i))), 83, 1);	// Config.Curve[i].Point6
-		memset((void*)((&Config.setup) + (CURVES_V1_3B1 + 6 + (8 * i))), 100, 1);	// Config.Curve[i].Point7
-	}
-
-	// Curves 2 to 6
-	for (i = 2; i < NUMBEROFCURVES; i++)
-	{
-		memset((void*)((&Config.setup) + (CURVES_V1_3B1 + 0 + (8 * i))), -100, 1);	// Config.Curve[i].Point1
-		memset((void*)((&Config.setup) + (CURVES_V1_3B1 + 1 + (8 * i))), -67, 1);	// Config.Curve[i].Point2
-		memset((void*)((&Config.setup) + (CURVES_V1_3B1 + 2 + (8 * i))), -33, 1);	// Config.Curve[i].Point3
-		memset((void*)((&Config.setup) + (CURVES_V1_3B1 + 3 + (8 * i))), 0, 1);		// Config.Curve[i].Point4
-		memset((void*)((&Config.setup) + (CURVES_V1_3B1 + 4 + (8 * i))), 33, 1);	// Config.Curve[i].Point5
-		memset((void*)((&Config.setup) + (CURVES_V1_3B1 + 5 + (8 * i))), 67, 1);	// Config.Curve[i].Point6
-		memset((void*)((&Config.setup) + (CURVES_V1_3B1 + 6 + (8 * i))), 100, 1);	// Config.Curve[i].Point7
-	}
-
-	// Set curve channel sources
-	memset((void*)((&Config.setup) + (CURVES_V1_3B1 + 7)), THROTTLE, 1);	// Config.Curve[0].channel
-	memset((void*)((&Config.setup) + (CURVES_V1_3B1 + 15)), THROTTLE, 1);	// Config.Curve[1].channel
-	memset((void*)((&Config.setup) + (CURVES_V1_3B1 + 23)), THROTTLE, 1);	// Config.Curve[2].channel
-	memset((void*)((&Config.setup) + (CURVES_V1_3B1 + 31)), THROTTLE, 1);	// Config.Curve[3].channel
-	memset((void*)((&Config.setup) + (CURVES_V1_3B1 + 39)), NOMIX, 1);		// Config.Curve[4].channel
-	memset((void*)((&Config.setup) + (CURVES_V1_3B1 + 47)), NOMIX, 1);		// Config.Curve[5].channel
-
-	// Preset custom channel order to JR
-	for (i = 0; i < MAX_RC_CHANNELS; i++)
-	{
-		memset((void*)((&Config.setup) + (CUSTOM_CH_ORD_V1_3_B1 + i)), pgm_read_byte(&JR[i]), 1);
-	}
 }
 
-void Update_V1_3B1_to_V1_3B14(void)
-{
-	int8_t TransitionSpeedOut = 0;
-	
-	// Copy Config.TransitionSpeedOut locally
-	memcpy((void*)&TransitionSpeedOut, (void*)((&Config.setup) + (RCITEMS_V1_0 + 5)), 1);
-	
-	// Move everything from Config.Transition_P1n up by one byte to make room for Config.TransitionSpeedIn
-	memmove((void*)((&Config.setup) + (RCITEMS_V1_0 + 7)), (void*)((&Config.setup) + (RCITEMS_V1_0 + 6)), (LAST_BYTE_V1_3B14 - (RCITEMS_V1_0 + 6))); // 619 - (41 + 6) = 572 bytes)
-
-	// Preset new variable to same as TransitionSpeedOut;
-	Config.TransitionSpeedIn = TransitionSpeedOut;
-
-	// Set magic number to V1.3 B1 signature
-	Config.setup = V1_3_B14_SIGNATURE;
-}
-
-// Upgrade V1.3 B14 structure to V1.3 B15 structure
-void Update_V1_3B14_to_V1_3B15(void)
+// Shrink the V1.3 B14 channel_t to the V1.3 B15 size
+void Convert_V1_3B14_to_V1_3B15(void)
 {
 	#define		V1_3_OLDSIZE 38				// Old channel_t was 38 bytes
 	#define		V1_3_NEWSIZE 34				// New channel_t is 34 bytes
 
-	int8_t		Transition_P1n = 0;
 	uint8_t		i;
 	uint8_t		*src;
 	uint8_t		*dst;
@@ -772,102 +1574,26 @@ void Update_V1_3B14_to_V1_3B15(void)
 		src += (i * V1_3_OLDSIZE);						// Step to next old data in (corrupted) config structure
 		memcpy(dst, src, 29);							// Move the 29 bytes (P1_throttle_volume to end)
 	}
-
-	// Move data that exists after the B14 channel mixer to new location
-	memmove((void*)((&Config.setup) + (SERVOREV_V1_3B15)), (void*)((&Config.setup) + (SERVOREV_V1_3B14)), (LAST_BYTE_V1_3B14 - SERVOREV_V1_3B14)); // (619-452 = 167 bytes)
-
-	// Clear new offset curves to zero (flat)
-	memset((void*)((&Config.setup) + (OFFSETS_V1_3_B15)), 0, (sizeof(curve_t) * MAX_OUTPUTS));
-
-	// Adjust for new Config.Transition_P1, Config.Transition_P2 variables
-	// Copy Config.TransitionSpeedOut locally
-	memcpy((void*)&Transition_P1n, (void*)((&Config.setup) + (RCITEMS_V1_0 + 7)), 1);
-	
-	// Move everything from Config.Transition_P1n up by two bytes to make room for new variables
-	memmove((void*)((&Config.setup) + (RCITEMS_V1_0 + 9)), (void*)((&Config.setup) + (RCITEMS_V1_0 + 7)), (LAST_BYTE_V1_3B15 - (RCITEMS_V1_0 + 7))); // 653 - (41 + 7) = 605 bytes)
-
-	// Preset new variables
-	Config.Transition_P1 = 0;
-	Config.Transition_P1n = Transition_P1n;
-	Config.Transition_P2 = 100;
-		
-	// Set magic number to V1.3 B15 signature
-	Config.setup = V1_3_B15_SIGNATURE;
 }
 
-void Update_V1_3B15_to_V1_3B17(void)
+// Convert V1.3 B15 sources to the V1.3 B17 source list
+void Convert_V1_3B15_to_V1_3B17(void)
 {
-	uint8_t		i;
+	uint8_t		i, j;
+	int8_t		*src;
 
 	// Fix any sources that have "NONE" to match new source list.
 	for (i = 0; i < MAX_OUTPUTS; i++)
 	{
-		// V1.3 B15 "NONE" will read as "Alt. Damp in B17
-		if (Config.Channel[i].P1_source_a == SRC20) Config.Channel[i].P1_source_a = NOMIX;
-		if (Config.Channel[i].P1_source_b == SRC20) Config.Channel[i].P1_source_b = NOMIX;
-		if (Config.Channel[i].P2_source_a == SRC20) Config.Channel[i].P2_source_a = NOMIX;
-		if (Config.Channel[i].P2_source_b == SRC20) Config.Channel[i].P2_source_b = NOMIX;
-	}
-	
-	// Set magic number to V1.3 B17 signature
-	Config.setup = V1_3_B17_SIGNATURE;	
-}
-
-void Update_V1_3_to_V1_4B2(void)
-{
-	int8_t elevator_polarity = 0;
-	
-	// Copy elevator_polarity locally
-	memcpy((void*)&elevator_polarity, (void*)((&Config.setup) + (ELE_POL_V1_3)), 1);
-	
-	// Set the new AccVertFilter to the default of 20 (old elevator polarity location)
-	memset((void*)((&Config.setup) + (ELE_POL_V1_3)), 20, 1);
-	
-	// Move everything from Config.PowerTriggerActual down by 12 bytes to make room for new variables
-	memmove((void*)((&Config.setup) + (POWER_TRIG_V1_4)), (void*)((&Config.setup) + (POWER_TRIG_V1_3)), (LAST_BYTE_V1_3B15 - POWER_TRIG_V1_3)); // 653 - 137 = 516 bytes
-	
-	// Move raw I constraints down 8 bytes
-	memmove((void*)((&Config.setup) + (SERVO_CONS_V1_4B8)), (void*)((&Config.setup) + (SERVO_CONS_V1_3)), 24); // 4 x [FLIGHT_MODES][NUMBEROFAXIS] = 24 bytes
-	
-	// Clear all the I-term constraints as they will be recalculated
-	memset((void*)((&Config.setup) + (SERVO_CONS_V1_4B8)), 0, 32);
-	
-	// Move raw I limits down 4 bytes
-	memmove((void*)((&Config.setup) + (SERVO_LIMS_V1_4B8)), (void*)((&Config.setup) + (SERVO_LIMS_V1_3)), 24); // 4 x [FLIGHT_MODES][NUMBEROFAXIS] = 24 bytes
-	
-	// Clear all the I-term limits as they will be recalculated
-	memset((void*)((&Config.setup) + (SERVO_LIMS_V1_4B8)), 0, 32);
-	
-	
-	// Move P2 profile down 2 bytes
-	memmove((void*)((&Config.setup) + (P2_PROFILE_V1_4B8)), (void*)((&Config.setup) + (P2_PROFILE_V1_3)), (P2_PROFILE_V1_4B8 - P1_PROFILE_V1_4B8)); // (73 - 53 = 18 bytes)
+		// P1_source_a, P2_source_a, P1_source_b and P2_source_b are every other byte from SOURCES_V1_3_B15
+		src = (int8_t*)((&Config.setup) + (CHANNEL_V1_3_B15 + SOURCES_V1_3_B15 + (i * V1_3_NEWSIZE)));
 
-	// Set the new Z parameters for P1
-	memset((void*)((&Config.setup) + (P1_PROFILE_V1_4B8 + 17)), 40, 1);
-	memset((void*)((&Config.setup) + (P1_PROFILE_V1_4B8 + 18)), 20, 1);
-	memset((void*)((&Config.setup) + (P1_PROFILE_V1_4B8 + 19)), 10, 1);
-
-	// Set the new Z parameters for P2
-	memset((void*)((&Config.setup) + (P2_PROFILE_V1_4B8 + 17)), 0, 3);
-			
-	// Preset new variable to same as elevator_polarity
-	memset((void*)((&Config.setup) + (ELE_POL_V1_4B8)), elevator_polarity, 1);
-	//Config.ElevatorPol = elevator_polarity;
-
-	// Set magic number to V1.4 B2 signature
-	Config.setup = V1_4_B2_SIGNATURE;	
-}
-
-void Update_V1_4B2_to_V1_4B8(void)
-{
-	// Move everything from Config.Buzzer down by 1 byte to make room for Config.Buzzer
-	memmove((void*)((&Config.setup) + (BUZZER_V1_4B2 + 1)), (void*)((&Config.setup) + (BUZZER_V1_4B2)), (LAST_BYTE_V1_4B2 - BUZZER_V1_4B2)); // 674 - 170 = 504 bytes
-
-	// Preset Buzzer to ON
-	memset((void*)((&Config.setup) + (BUZZER_V1_4B2)), ON, 1);
-
-	// Set magic number to V1.4 B8 signature
-	Config.setup = V1_4_B8_SIGNATURE;	
+		for (j = 0; j < 8; j += 2)
+		{
+			// V1.3 B15 "NONE" will read as "Alt. Damp in B17
+			if (src[j] == SRC20) src[j] = NOMIX;
+		}
+	}
 }
 
 // Convert V1.0 filter settings
@@ -931,8 +1657,9 @@ void Set_EEPROM_Default_Config(void)
 {
 	uint8_t i;
 	
-	// Clear entire Config space first
-	memset(&Config.setup,0,(sizeof(Config)));
+	// Clear the saved settings first.
+	// The derived values stay valid until UpdateLimits() runs.
+	memset(&Config.setup,0,CONFIG_SAVED_SIZE);
 
 	// Set magic number to current signature
 	Config.setup = MAGIC_NUMBER;
@@ -972,7 +1699,6 @@ void Set_EEPROM_Default_Config(void)
 	// Defaults
 	for (i = 0; i < MAX_RC_CHANNELS; i++)
 	{
-		Config.ChannelOrder[i] = pgm_read_byte(&JR[i]);			// Preset channel order to JR
 		Config.CustomChannelOrder[i] = pgm_read_byte(&JR[i]);	// Preset custom channel order to JR
 		Config.RxChannelZeroOffset[i] = 3750;					// Reset RX channel offsets
 	}
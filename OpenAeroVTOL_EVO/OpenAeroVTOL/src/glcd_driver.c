@@ -28,21 +28,51 @@
 //* Includes
 //***********************************************************
 
-#include <avr/io.h>
+#include <avr/io.h>
 #include <stdlib.h>
+#include <stdbool.h>
 #include <string.h>
 #include <util/delay.h>
 #include <avr/pgmspace.h> 
 #include "glcd_driver.h"
 #include "io_cfg.h"
 #include "main.h"
+#include "uart.h"
 
 void glcd_delay(void);
 void glcd_delay_1us(void);
 void glcd_spiwrite_asm(uint8_t byte);
 void write_buffer(uint8_t *buffer);
+void queue_buffer(uint8_t *buffer);
+bool stream_buffer(uint8_t *buffer, uint8_t bytes);
+uint16_t lcd_checksum(uint8_t *data);
+void lcd_set_address(uint8_t page, uint8_t seg);
+bool lcd_waiting(void);
 void clear_screen(void);
 
+//***********************************************************
+//* Defines
+//***********************************************************
+
+#define LCD_SEGMENTS 4							// Column ranges per page that are checked for changes
+#define LCD_SEGWIDTH (LCDWIDTH / LCD_SEGMENTS)	// 32 columns each
+#define LCD_CRC_INIT 0xFFFF
+
+//***********************************************************
+//* Variables
+//***********************************************************
+
+uint16_t lcd_sums[8][LCD_SEGMENTS];				// Checksums of the data last sent to each part of the LCD
+bool lcd_sums_valid = false;					// False when the LCD contents are not known
+
+uint8_t lcd_unchecked[8];						// Parts of each page queued but not yet checked for changes
+uint8_t lcd_pending[8];							// Parts of each page waiting to be streamed
+bool lcd_streaming = false;						// True while any part is unchecked or waiting
+bool lcd_stream_addressed = false;				// True once the LCD address is set for the part being streamed
+uint8_t lcd_stream_page = 0;					// Part being streamed
+uint8_t lcd_stream_seg = 0;
+uint8_t lcd_stream_col = 0;						// Next column of that part
+
 //***********************************************************
 //* Low-level code
 //***********************************************************
@@ -74,7 +104,13 @@ inline void spiwrite(uint8_t c)
 
 // Send command to LCD
 void st7565_command(uint8_t c) 
-{
+{
+	// Flipping the display moves every page, so the whole LCD has to be resent
+	if ((c == CMD_SET_COM_NORMAL) || (c == CMD_SET_COM_REVERSE))
+	{
+		lcd_sums_valid = false;
+	}
+
 	LCD_A0 = 0;
 	spiwrite(c);
 }
@@ -113,22 +149,203 @@ void st7565_set_brightness(uint8_t val)
 	st7565_command(val);
 }
 
+// CRC16 (CCITT) of one 32-column part of a page.
+// A part is 256 bits. Over that length CRC-CCITT catches every change of up to three bits,
+// so a pixel set, cleared or moved is never missed. A simple sum can't promise that.
+uint16_t lcd_checksum(uint8_t *data)
+{
+	uint8_t c;
+	uint16_t crc = LCD_CRC_INIT;
+
+	for(c = 0; c < LCD_SEGWIDTH; c++) 
+	{
+		crc = CRC16(crc, data[c]);
+	}
+
+	return crc;
+}
+
+// Point the LCD at the start of one part of a page
+void lcd_set_address(uint8_t page, uint8_t seg)
+{
+	st7565_command(CMD_SET_PAGE | (uint8_t)pgm_read_byte(&pagemap[page]));		// Page 7 to 0
+	st7565_command(CMD_SET_COLUMN_LOWER | ((seg * LCD_SEGWIDTH) & 0xf));		// Column
+	st7565_command(CMD_SET_COLUMN_UPPER | (((seg * LCD_SEGWIDTH) >> 4) & 0xf));	// Column
+	st7565_command(CMD_RMW);													// Sets auto-increment
+}
+
 // Write LCD buffer
+// Only the parts of each page that differ from what the LCD already shows are sent.
+// Menus clear and redraw the whole buffer each pass, so changes are found by comparing 
+// a CRC of each 32-column part of a page against the one last sent.
+// Anything still waiting to be streamed is sent too.
 void write_buffer(uint8_t *buffer) 
-{
-	uint8_t c, p;
+{
+	uint8_t c, p, s;
+	uint16_t sum;
+	uint8_t *data;
+	bool addressed;
+
 	for(p = 0; p < 8; p++) 
-	{
-		st7565_command(CMD_SET_PAGE | (uint8_t)pgm_read_byte(&pagemap[p]));		// Page 7 to 0
-		st7565_command(CMD_SET_COLUMN_LOWER | (0x0 & 0xf));						// Column 0
-		st7565_command(CMD_SET_COLUMN_UPPER | ((0x0 >> 4) & 0xf));				// Column 0
-		st7565_command(CMD_RMW);												// Sets auto-increment
-
-		for(c = 0; c < 128; c++) 
-		{
-			st7565_data(buffer[(128*p)+c]);
-		}
-	}
+	{
+		addressed = false;
+
+		for (s = 0; s < LCD_SEGMENTS; s++)
+		{
+			data = &buffer[(128*p) + (s * LCD_SEGWIDTH)];
+			sum = lcd_checksum(data);
+
+			// Skip this part if the LCD already shows it
+			if (lcd_sums_valid && (lcd_sums[p][s] == sum) && !(lcd_pending[p] & (1 << s)))
+			{
+				addressed = false;
+				continue;
+			}
+
+			lcd_sums[p][s] = sum;
+
+			// Set the address unless it follows on from the last part sent
+			if (!addressed)
+			{
+				lcd_set_address(p, s);
+				addressed = true;
+			}
+
+			for(c = 0; c < LCD_SEGWIDTH; c++) 
+			{
+				st7565_data(data[c]);
+			}
+		}
+
+		lcd_unchecked[p] = 0;
+		lcd_pending[p] = 0;
+	}
+
+	lcd_sums_valid = true;
+
+	// Cancel any streaming in progress
+	lcd_streaming = false;
+	lcd_stream_addressed = false;
+	lcd_stream_col = 0;
+}
+
+// Queue the LCD buffer to be sent a few bytes at a time by stream_buffer().
+// The parts are checked for changes by stream_buffer() too, so this takes no time.
+// The buffer must then be left alone until stream_buffer() returns false, or be queued again.
+void queue_buffer(uint8_t *buffer)
+{
+	uint8_t p;
+
+	for(p = 0; p < 8; p++) 
+	{
+		lcd_unchecked[p] = (1 << LCD_SEGMENTS) - 1;
+
+		// Send everything if the LCD contents are not known
+		if (!lcd_sums_valid)
+		{
+			lcd_pending[p] = (1 << LCD_SEGMENTS) - 1;
+		}
+	}
+
+	lcd_sums_valid = true;
+	lcd_streaming = true;
+}
+
+// Check if any part is still unchecked or waiting to be sent
+bool lcd_waiting(void)
+{
+	uint8_t p;
+
+	for (p = 0; p < 8; p++)
+	{
+		if (lcd_unchecked[p] || lcd_pending[p])
+		{
+			return true;
+		}
+	}
+
+	return false;
+}
+
+// Send up to "bytes" bytes of the queued LCD data, including address commands.
+// At most one part is checked for changes per call, as its CRC takes about as long as sending six bytes.
+// Returns true while there is more to check or send.
+bool stream_buffer(uint8_t *buffer, uint8_t bytes)
+{
+	uint16_t sum;
+	bool checked = false;
+
+	while (lcd_streaming && (bytes > 0))
+	{
+		// Check the part for changes when it is reached
+		if (lcd_unchecked[lcd_stream_page] & (1 << lcd_stream_seg))
+		{
+			if (checked)
+			{
+				break;
+			}
+
+			checked = true;
+			lcd_unchecked[lcd_stream_page] &= ~(1 << lcd_stream_seg);
+			sum = lcd_checksum(&buffer[(128*lcd_stream_page) + (lcd_stream_seg * LCD_SEGWIDTH)]);
+
+			// Send the part, from the start if it was already being sent
+			if (lcd_sums[lcd_stream_page][lcd_stream_seg] != sum)
+			{
+				lcd_sums[lcd_stream_page][lcd_stream_seg] = sum;
+				lcd_pending[lcd_stream_page] |= (1 << lcd_stream_seg);
+				lcd_stream_addressed = false;
+				lcd_stream_col = 0;
+			}
+			else
+			{
+				lcd_streaming = lcd_waiting();
+			}
+		}
+
+		// Move on to the next part
+		if (!(lcd_pending[lcd_stream_page] & (1 << lcd_stream_seg)))
+		{
+			lcd_stream_addressed = false;
+			lcd_stream_col = 0;
+
+			if (++lcd_stream_seg >= LCD_SEGMENTS)
+			{
+				lcd_stream_seg = 0;
+				lcd_stream_page = (lcd_stream_page + 1) & 7;
+			}
+
+			continue;
+		}
+
+		// Set the address at the start of each part. This costs four bytes.
+		if (!lcd_stream_addressed)
+		{
+			if (bytes < 4)
+			{
+				break;
+			}
+
+			lcd_set_address(lcd_stream_page, lcd_stream_seg);
+			lcd_stream_addressed = true;
+			bytes -= 4;
+			continue;
+		}
+
+		st7565_data(buffer[(128*lcd_stream_page) + (lcd_stream_seg * LCD_SEGWIDTH) + lcd_stream_col]);
+		bytes--;
+
+		// Part done
+		if (++lcd_stream_col >= LCD_SEGWIDTH)
+		{
+			lcd_pending[lcd_stream_page] &= ~(1 << lcd_stream_seg);
+			lcd_stream_addressed = false;
+			lcd_stream_col = 0;
+			lcd_streaming = lcd_waiting();
+		}
+	}
+
+	return lcd_streaming;
 }
 
 // Clear buffer
@@ -142,6 +359,9 @@ void clear_screen(void)
 {
 	uint8_t p, c;
 
+	lcd_sums_valid = false;											// Next write_buffer() sends everything
+	lcd_stream_addressed = false;
+
 	for(p = 0; p < 8; p++)
 	{
 		st7565_command(CMD_SET_PAGE | p);								// Set page to p
@@ -85,7 +85,8 @@ const char MainMenuItem22[] PROGMEM = "20. Neg. Servo trvl. (%)";
 const char MainMenuItem23[] PROGMEM = "21. Pos. Servo trvl. (%)";
 const char MainMenuItem32[] PROGMEM = "22. Custom Ch. order";
 const char MainMenuItem31[] PROGMEM = "23. In/Out display";
-const char MainMenuItem24[] PROGMEM = "24. Error log";
+const char MainMenuItem33[] PROGMEM = "24. Models";
+const char MainMenuItem24[] PROGMEM = "25. Error log";
 //
 const char PText15[] PROGMEM = "Gyro";		 				// Sensors text
 const char PText16[] PROGMEM = "Roll";
@@ -141,6 +142,8 @@ const char RXMode3[]  PROGMEM = "Spektrum";
 const char RXMode4[]  PROGMEM = "Xtreme";
 const char RXMode5[]  PROGMEM = "Mode B/UDI";
 const char RXMode6[]  PROGMEM = "HoTT SUMD";
+const char RXMode7[]  PROGMEM = "FlySky IBUS";
+const char RXMode8[]  PROGMEM = "CRSF";
 //
 const char RCMenuItem6[]  PROGMEM = "JR/Spektrum"; 			// Channel order
 const char RCMenuItem7[]  PROGMEM = "Futaba"; 
@@ -159,6 +162,9 @@ const char GeneralText7[] PROGMEM =  "AL correct:";
 const char BattMenuItem2[]  PROGMEM = "Low V alarm:";
 const char GeneralText20[] PROGMEM =  "Preset:";
 const char GeneralText21[] PROGMEM =  "Buzzer:";
+const char GeneralText22[] PROGMEM =  "Board roll:";
+const char GeneralText23[] PROGMEM =  "Board pitch:";
+const char GeneralText24[] PROGMEM =  "Board yaw:";
 //
 const char MixerMenuItem1[]  PROGMEM = "P1 orientn.:";		// Advanced text
 const char MixerMenuItem8[]  PROGMEM = "P1 refrnce.:";
@@ -372,10 +378,41 @@ const char ERROR_0[] PROGMEM =  "Reboot";
 const char ERROR_1[] PROGMEM =  "Manual disarm";
 const char ERROR_2[] PROGMEM =  "No signal";
 const char ERROR_3[] PROGMEM =  "Disarm timer";
-const char ERROR_4[] PROGMEM =  "BOD reset";
+const char ERROR_4[] PROGMEM =  "RX errors";
 
 const char ERROR_MSG_0[] PROGMEM =  "Clear";
 
+const char RxStats_0[] PROGMEM =  "Frames:";				// RC link statistics
+const char RxStats_1[] PROGMEM =  "Bad CRC:";
+const char RxStats_2[] PROGMEM =  "Lost:";
+const char RxStats_3[] PROGMEM =  "Errors:";
+const char RxStats_4[] PROGMEM =  "Sync:";
+const char RxStats_5[] PROGMEM =  "Latency";
+const char RxStats_6[] PROGMEM =  "2ms/bar";
+const char RxStats_7[] PROGMEM =  "11ms";
+const char RxStats_8[] PROGMEM =  "22ms";
+const char I2CStats[] PROGMEM =  "I2C:";
+const char TempCal_0[] PROGMEM =  "Temp.";
+const char TempCal_1[] PROGMEM =  "Temp:";
+const char TempCal_2[] PROGMEM =  "Span:";
+const char AccCal_0[] PROGMEM =  "Sides:";
+const char AccCal_1[] PROGMEM =  "+X";
+const char AccCal_2[] PROGMEM =  "-X";
+const char AccCal_3[] PROGMEM =  "+Y";
+const char AccCal_4[] PROGMEM =  "-Y";
+const char AccCal_5[] PROGMEM =  "+Z";
+const char AccCal_6[] PROGMEM =  "-Z";
+const char ModelText0[] PROGMEM =  "Load model 1";
+const char ModelText1[] PROGMEM =  "Load model 2";
+const char ModelText2[] PROGMEM =  "Load model 3";
+const char ModelText3[] PROGMEM =  "Load model 4";
+const char ModelText4[] PROGMEM =  "Save model 1";
+const char ModelText5[] PROGMEM =  "Save model 2";
+const char ModelText6[] PROGMEM =  "Save model 3";
+const char ModelText7[] PROGMEM =  "Save model 4";
+const char ModelText8[] PROGMEM =  "Empty";
+const char ModelText9[] PROGMEM =  "No room";
+
 //const char Misc_Msg01[]  PROGMEM = "Alt. Damp:";
 const char Misc_Msg01[]  PROGMEM = "Alt.";
 
@@ -495,14 +532,13 @@ const char* const text_menu[] PROGMEM =
 		ErrorText3, ErrorText4,																// 75 to 76 Error messages
 		//
 		MainMenuItem0, MainMenuItem1, MainMenuItem9, MainMenuItem7, MainMenuItem8, 
-		MainMenuItem10, MainMenuItem2, MainMenuItem3,MainMenuItem30,						// 77 to 100 Main menu
+		MainMenuItem10, MainMenuItem2, MainMenuItem3,MainMenuItem30,						// 77 to 101 Main menu
 		MainMenuItem25, MainMenuItem11,MainMenuItem12,MainMenuItem13,MainMenuItem14,
 		MainMenuItem15,MainMenuItem16,MainMenuItem17,MainMenuItem18,		
 		MainMenuItem20,MainMenuItem22, MainMenuItem23,MainMenuItem32, MainMenuItem31, 
-		MainMenuItem24, 
+		MainMenuItem33, MainMenuItem24, 
 		//
-		Dummy0, Dummy0,																		// 101 to 104 Spare
-		Dummy0, Dummy0,
+		Dummy0, Dummy0, Dummy0,															// 102 to 104 Spare
 		//
 		ChannelRef0, ChannelRef1, ChannelRef2, ChannelRef3, ChannelRef4, 					// 105 to 115 Ch. names
 		ChannelRef5, ChannelRef6, ChannelRef7, ChannelRef8,		
@@ -533,12 +569,8 @@ const char* const text_menu[] PROGMEM =
 		TransitionOut, TransitionIn, Transition_P1, Transition_P1n,
 		Transition_P2, RCMenuItem30, RCMenuItem300,
 		//
-		MixerMenuItem0, GeneralText100, Contrast, AutoMenuItem2,							// 158 to 169 General
-		GeneralText2, BattMenuItem2, GeneralText10, 
-		GeneralText6, GeneralText16, GeneralText7, 
-		GeneralText20, GeneralText21,
-		//
-		Dummy0, Dummy0,																		// 170 to 171 Spare
+		Dummy0, Dummy0, Dummy0, Dummy0, Dummy0, Dummy0, Dummy0,								// 158 to 171 Spare (General moved to 496)
+		Dummy0, Dummy0, Dummy0, Dummy0, Dummy0, Dummy0, Dummy0,
 		//
 		// Special Model reference text
 		//
@@ -661,17 +693,17 @@ const char* const text_menu[] PROGMEM =
 		// <--- Special Model reference texts
 		//
 		Dummy0,	Dummy0,	
-		Dummy0, Dummy0,	Dummy0,	Dummy0,														// 378 to 383 Spare
+		Dummy0, Dummy0, Dummy0,Dummy0,														// 378 to 383 Spare
 		//
 		Ch1, Ch2, Ch3, Ch4,																	// 384 to 391 TX channel numbers												
 		Ch5, Ch6, Ch7, Ch8,		
 		
-		//	
-		Dummy0, Dummy0, Dummy0, Dummy0, 													// 392 to 395 Spare
-		
 		//
-		RXMode0, RXMode1, RXMode2, RXMode3,													// 396 to 402 RX mode
-		RXMode4, RXMode5, RXMode6, 
+		RXMode0, RXMode1, RXMode2, RXMode3,													// 392 to 400 RX mode
+		RXMode4, RXMode5, RXMode6, RXMode7, 
+		RXMode8,
+		//	
+		Dummy0, Dummy0,																		// 401 to 402 Spare
 		//
 		Curve_0,Curve_1,Curve_2,Curve_3,Curve_4,Curve_5,Dummy0,								// 403 Curves
 		//
@@ -701,6 +733,25 @@ const char* const text_menu[] PROGMEM =
 		I1, I2, I3, I4, I5, I6, I7, I8, I9, I10,											// 468 to 477
 		//
 		O0, O1, O2, O3, O4, O5, O6, O7,														// 478 to 485
+		//
+		RxStats_0, RxStats_1, RxStats_2, RxStats_3, RxStats_4, RxStats_5, RxStats_6,		// 486 to 492 RC link statistics
+		RxStats_7, RxStats_8,																// 493 to 494 Spektrum frame period
+		//
+		I2CStats,																			// 495 I2C error count
+		//
+		MixerMenuItem0, GeneralText100, Contrast, AutoMenuItem2,							// 496 to 510 General
+		GeneralText2, BattMenuItem2, GeneralText10, 
+		GeneralText6, GeneralText16, GeneralText7, 
+		GeneralText20, GeneralText21, GeneralText22,
+		GeneralText23, GeneralText24,
+		//
+		TempCal_0, TempCal_1, TempCal_2,													// 511 to 513 Temperature calibration
+		//
+		AccCal_0, AccCal_1, AccCal_2, AccCal_3, AccCal_4, AccCal_5, AccCal_6,				// 514 to 520 Six-position acc calibration
+		//
+		ModelText0, ModelText1, ModelText2, ModelText3,										// 521 to 528 Model memories
+		ModelText4, ModelText5, ModelText6, ModelText7,
+		ModelText8, ModelText9,																// 529, 530 Empty, No room
 	}; 
 
 //************************************************************
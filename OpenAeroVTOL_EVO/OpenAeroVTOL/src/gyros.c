@@ -12,6 +12,7 @@
 
 #include "compiledefs.h"
 #include <string.h>
+#include <stdlib.h>
 #include <avr/io.h>
 #include <stdbool.h>
 #include <util/delay.h>
@@ -21,6 +22,7 @@
 #include "i2c.h"
 #include "MPU6050.h"
 #include "main.h"
+#include "acc.h"
 #include "imu.h"
 #include "eeprom.h"
 #include "mixer.h"
@@ -32,8 +34,24 @@
 
 void ReadGyros(void);
 void CalibrateGyrosFast(void);
+void AverageGyroZeros(void);
 bool CalibrateGyrosSlow(void);
 void get_raw_gyros(void);
+void init_i2c_lpf(void);
+void UpdateOrientation(void);
+void CompileOrientation(orient_t* orient, const int8_t* order, const int8_t* pol);
+void UpdateOrientationWeights(orient_t* orient);
+void UpdateBoardMatrix(void);
+void AlignBoard(int16_t* vector);
+void TrackGyroBias(void);
+void ApplyGyroBias(void);
+bool UseGyroBias(void);
+void TempCompensate(int16_t* vector, const int16_t* tempco);
+void TempCoStart(void);
+void TempCoSample(void);
+int16_t TempCoSpan(void);
+int16_t TempCoCoefficient(uint8_t channel);
+void TempCoSave(void);
 
 //************************************************************
 // Defines
@@ -47,6 +65,14 @@ void get_raw_gyros(void);
 #define GYROFS2000DEG 0x18			// 2000 deg/s full scale
 #define GYROFS500DEG 0x08			// 500 deg/s full scale
 #define GYROFS250DEG 0x00			// 250 deg/s full scale
+#define BOARD_Q14 16384				// 1.0 in the board alignment matrix
+#define DEG_TO_RAD 0.0174533f		// Degrees to radians
+#define BIAS_SHIFT 8				// 256 still samples per background bias estimate
+#define BIAS_GYRO_STILL 2			// Largest gyro change while still (about 2 deg/s)
+#define BIAS_ACC_STILL 4			// Largest acc change while still (about 0.03G)
+#define TEMPCO_BLOCK 64				// Samples averaged into each temperature calibration point
+#define TEMPCO_CHANNELS 7			// Gyro X, Y, Z, Acc X, Y, Z and the temperature
+#define TEMPCO_TEMP 6				// Temperature channel
 
 //***********************************************************
 // ROLL, PITCH, YAW mapping for alternate orientation modes
@@ -134,6 +160,26 @@ int16_t gyroADCalt[NUMBEROFAXIS];		// Holds Gyro data - always in RPY order (Com
 int16_t gyroADC_P1[NUMBEROFAXIS];		// Holds temp Gyro data - always in RPY order (P1)
 int16_t gyroADC_P2[NUMBEROFAXIS];		// Holds temp Gyro data - always in RPY order (P2)
 
+orient_t Gyro_Orient;					// Gyro orientation, compiled from the tables above
+int16_t BoardMatrix[NUMBEROFAXIS][NUMBEROFAXIS];	// Board alignment rotation matrix (Q14)
+bool BoardSquare = true;				// True if the board needs no alignment
+
+int16_t GyroBias[NUMBEROFAXIS];			// Last background bias estimate, in gyroADC_raw[] order
+bool GyroBiasFresh = false;				// True if the board has been still since GyroBias[] was measured
+int16_t BiasGyroRef[NUMBEROFAXIS];		// Gyro reading at the start of the current window
+int16_t BiasAccRef[NUMBEROFAXIS];		// Acc reading at the start of the current window
+int32_t BiasSum[NUMBEROFAXIS];			// Sum of gyro readings in the current window
+uint16_t BiasCount = 0;					// Readings in the current window
+bool BiasRefValid = false;				// True once BiasGyroRef[] and BiasAccRef[] are set
+
+int32_t TempCoSum[TEMPCO_CHANNELS];		// Sum of raw readings in the current block
+float TempCoMean[TEMPCO_CHANNELS];		// Running mean of the block averages
+float TempCoCov[TEMPCO_CHANNELS];		// Running co-moment of each channel with the temperature
+uint8_t TempCoSamples = 0;				// Readings in the current block
+uint16_t TempCoPoints = 0;				// Completed blocks
+int16_t TempCoMin;						// Lowest block temperature seen
+int16_t TempCoMax;						// Highest block temperature seen
+
 //***************************************************************
 // Fill gyroADC[] and gyroADCalt[] with RPY data appropriate to
 // the board orientation and users' P1 referencing setting
@@ -155,19 +201,28 @@ void ReadGyros(void)					// Conventional orientation
 
 	get_raw_gyros();					// Updates gyroADC_P1[] and gyroADC_P2[]
 
+	// Polarity and transition weights only change when the transition moves
+	if (Gyro_Orient.transition != transition)
+	{
+		UpdateOrientationWeights(&Gyro_Orient);
+	}
+
 	for (i = 0; i < NUMBEROFAXIS; i++)	
 	{
 		// Only need to do this if the orientations differ
 		if (Config.P1_Reference != NO_ORIENT)
 		{
 			// P1 alternate (original) orientation. Swap zeros so that they match.
-			temp1 = (gyroADC_P1[i] - Config.gyroZero_P1[i]) * (int8_t)pgm_read_byte(&Gyro_Pol[Config.Orientation_P1][i]);
+			temp1 = gyroADC_P1[i] - Config.gyroZero_P1[i];
 
 			// P2 orientation
-			temp2 = (gyroADC_P2[i] - Config.gyroZero_P2[i]) * (int8_t)pgm_read_byte(&Gyro_Pol[Config.Orientation_P2][i]);
+			temp2 = gyroADC_P2[i] - Config.gyroZero_P2[i];
 
-			// Merge the two gyros per transition percentage
-			temp3 = scale32(temp1, (100 - transition)) + scale32(temp2, transition); // Sum the two values
+			// Change polarity and merge the two gyros per transition percentage
+			temp3 = scale32(temp1, Gyro_Orient.weight[P1][i]) + scale32(temp2, Gyro_Orient.weight[P2][i]); // Sum the two values
+			
+			// Polarity-corrected P2 value
+			temp2 = temp2 * Gyro_Orient.pol[P2][i];
 
 			// Gyro alt is always per orientation
 			gyroADCalt[i] = temp3;
@@ -190,7 +245,7 @@ void ReadGyros(void)					// Conventional orientation
 		else
 		{
 			// Change polarity using P2 orientation by default
-			gyroADC[i] = (gyroADC_P2[i] - Config.gyroZero_P2[i]) * (int8_t)pgm_read_byte(&Gyro_Pol[Config.Orientation_P2][i]);	
+			gyroADC[i] = (gyroADC_P2[i] - Config.gyroZero_P2[i]) * Gyro_Orient.pol[P2][i];	
 				
 			// Copy to alternate set of gyro values
 			gyroADCalt[i] = gyroADC[i];
@@ -200,7 +255,7 @@ void ReadGyros(void)					// Conventional orientation
 
 //***************************************************************
 // Fill gyroADC_P1[] and gyroADC_P2[] with RPY data appropriate to 
-// the board orientation.
+// the board orientation. The data comes from the last ReadSensors().
 // Nice as it would be, we cannot remove zeros here as this is the
 // routine used by the zeroing calibration routine. Chicken | Egg.
 // We also cannot merge P1 and P2 here as each have their own zeros.
@@ -209,22 +264,177 @@ void ReadGyros(void)					// Conventional orientation
 void get_raw_gyros(void)
 {
 	uint8_t i;
-	uint8_t Gyros[6];
+	int16_t RawADC[NUMBEROFAXIS];
+	uint8_t* Gyros = &SensorSample[SENSOR_GYRO];
+
+	// Reassemble the MPU6050's X, Y, Z data, remove temperature drift and correct any board misalignment
+	RawADC[0] = (Gyros[0] << 8) + Gyros[1];
+	RawADC[1] = (Gyros[2] << 8) + Gyros[3];
+	RawADC[2] = (Gyros[4] << 8) + Gyros[5];
+	TempCompensate(RawADC, Config.GyroTempCo);
+	AlignBoard(RawADC);
+
+	// Rearrange into gyroADC array
+	gyroADC_raw[PITCH] = RawADC[0];
+	gyroADC_raw[ROLL] = RawADC[1];
+	gyroADC_raw[YAW] = RawADC[2];
+
+	// Reorient the data as per the board orientation and down-sample to reduce resolution and noise
+	for (i = 0; i < NUMBEROFAXIS; i++)
+	{
+		// Rearrange the sensors for both orientations
+		gyroADC_P1[i] = gyroADC_raw[Gyro_Orient.axis[P1][i]] >> GYRODIV;
+		gyroADC_P2[i] = gyroADC_raw[Gyro_Orient.axis[P2][i]] >> GYRODIV;
+	}
+}
 
-	// Get the i2c data from the MPU6050
-	readI2CbyteArray(MPU60X0_DEFAULT_ADDRESS,MPU60X0_RA_GYRO_XOUT_H,(uint8_t *)Gyros,6);
+//***************************************************************
+// Orientation management
+//
+// The PROGMEM tables are compiled into RAM whenever the settings 
+// change, so the per-sample code above is a straight indexed copy.
+// UpdateOrientation() is called at start-up and from UpdateLimits().
+//***************************************************************
 
-	// Reassemble data into gyroADC array and down-sample to reduce resolution and noise
-	gyroADC_raw[PITCH] = (Gyros[0] << 8) + Gyros[1];
-	gyroADC_raw[ROLL] = (Gyros[2] << 8) + Gyros[3];
-	gyroADC_raw[YAW] = (Gyros[4] << 8) + Gyros[5];
+void UpdateOrientation(void)
+{
+	CompileOrientation(&Gyro_Orient, &Gyro_RPY_Order[0][0], &Gyro_Pol[0][0]);
+	UpdateAccOrientation();
+	UpdateBoardMatrix();
+}
+
+// Copy the axis order and polarity for the current P1 and P2 orientations
+void CompileOrientation(orient_t* orient, const int8_t* order, const int8_t* pol)
+{
+	uint8_t i;
+	uint8_t P1_offset = Config.Orientation_P1 * NUMBEROFAXIS;
+	uint8_t P2_offset = Config.Orientation_P2 * NUMBEROFAXIS;
 
-	// Reorient the data as per the board orientation	
 	for (i = 0; i < NUMBEROFAXIS; i++)
 	{
-		// Rearrange the sensors for both orientations
-		gyroADC_P1[i] = gyroADC_raw[(int8_t)pgm_read_byte(&Gyro_RPY_Order[Config.Orientation_P1][i])] >> GYRODIV;
-		gyroADC_P2[i] = gyroADC_raw[(int8_t)pgm_read_byte(&Gyro_RPY_Order[Config.Orientation_P2][i])] >> GYRODIV;
+		orient->axis[P1][i] = (uint8_t)pgm_read_byte(&order[P1_offset + i]);
+		orient->axis[P2][i] = (uint8_t)pgm_read_byte(&order[P2_offset + i]);
+		orient->pol[P1][i] = (int8_t)pgm_read_byte(&pol[P1_offset + i]);
+		orient->pol[P2][i] = (int8_t)pgm_read_byte(&pol[P2_offset + i]);
+	}
+
+	// Recalculate the weights for the new polarities
+	UpdateOrientationWeights(orient);
+}
+
+// Fold the polarity into the P1/P2 transition percentages.
+// scale32(value, pol * percent) is exactly scale32(value * pol, percent).
+void UpdateOrientationWeights(orient_t* orient)
+{
+	uint8_t i;
+
+	for (i = 0; i < NUMBEROFAXIS; i++)
+	{
+		orient->weight[P1][i] = orient->pol[P1][i] * (100 - transition);
+		orient->weight[P2][i] = orient->pol[P2][i] * transition;
+	}
+
+	orient->transition = transition;
+}
+
+//***************************************************************
+// Board alignment for boards that sit between the 24 orientations
+//
+// Config.BoardAngle[] holds the board's angle from the selected
+// orientation about its own roll (MPU6050 Y), pitch (X) and yaw (Z)
+// axes. The raw X, Y, Z data is rotated by M = Rz(yaw).Rx(pitch).Ry(roll)
+// before being reoriented. The gyros and accs share the same axes.
+//***************************************************************
+
+void UpdateBoardMatrix(void)
+{
+	float	sine[NUMBEROFAXIS], cosine[NUMBEROFAXIS];
+	float	matrix[NUMBEROFAXIS][NUMBEROFAXIS];
+	float	angle, angle2;
+	uint8_t	i, j;
+
+	BoardSquare = true;
+
+	for (i = 0; i < NUMBEROFAXIS; i++)
+	{
+		if (Config.BoardAngle[i] != 0)
+		{
+			BoardSquare = false;
+		}
+
+		// Angles are limited to +/-45 degrees, so a short series is plenty
+		angle = Config.BoardAngle[i] * DEG_TO_RAD;
+		angle2 = angle * angle;
+		sine[i] = angle * (1 - (angle2 / 6) * (1 - (angle2 / 20)));
+		cosine[i] = 1 - (angle2 / 2) * (1 - (angle2 / 12) * (1 - (angle2 / 30)));
+	}
+
+	// Row 0 (X)
+	matrix[0][0] = (cosine[YAW] * cosine[ROLL]) - (sine[YAW] * sine[PITCH] * sine[ROLL]);
+	matrix[0][1] = -(sine[YAW] * cosine[PITCH]);
+	matrix[0][2] = (cosine[YAW] * sine[ROLL]) + (sine[YAW] * sine[PITCH] * cosine[ROLL]);
+
+	// Row 1 (Y)
+	matrix[1][0] = (sine[YAW] * cosine[ROLL]) + (cosine[YAW] * sine[PITCH] * sine[ROLL]);
+	matrix[1][1] = cosine[YAW] * cosine[PITCH];
+	matrix[1][2] = (sine[YAW] * sine[ROLL]) - (cosine[YAW] * sine[PITCH] * cosine[ROLL]);
+
+	// Row 2 (Z)
+	matrix[2][0] = -(cosine[PITCH] * sine[ROLL]);
+	matrix[2][1] = sine[PITCH];
+	matrix[2][2] = cosine[PITCH] * cosine[ROLL];
+
+	// Convert to fixed point
+	for (i = 0; i < NUMBEROFAXIS; i++)
+	{
+		for (j = 0; j < NUMBEROFAXIS; j++)
+		{
+			if (matrix[i][j] < 0)
+			{
+				BoardMatrix[i][j] = (int16_t)((matrix[i][j] * BOARD_Q14) - 0.5f);
+			}
+			else
+			{
+				BoardMatrix[i][j] = (int16_t)((matrix[i][j] * BOARD_Q14) + 0.5f);
+			}
+		}
+	}
+}
+
+// Rotate a raw X, Y, Z sensor vector by the board alignment matrix
+void AlignBoard(int16_t* vector)
+{
+	int16_t	input[NUMBEROFAXIS];
+	int32_t	temp32;
+	uint8_t	i;
+
+	// Nothing to do for a board that is square to the model
+	if (BoardSquare)
+	{
+		return;
+	}
+
+	memcpy(input, vector, sizeof(input));
+
+	for (i = 0; i < NUMBEROFAXIS; i++)
+	{
+		temp32 = ((int32_t)BoardMatrix[i][0] * input[0]) + 
+				 ((int32_t)BoardMatrix[i][1] * input[1]) + 
+				 ((int32_t)BoardMatrix[i][2] * input[2]);
+
+		// Round, remove the Q14 scaling and keep within range
+		temp32 = (temp32 + (BOARD_Q14 / 2)) >> 14;
+
+		if (temp32 > INT16_MAX)
+		{
+			temp32 = INT16_MAX;
+		}
+		else if (temp32 < INT16_MIN)
+		{
+			temp32 = INT16_MIN;
+		}
+
+		vector[i] = (int16_t)temp32;
 	}
 }
 
@@ -232,7 +442,15 @@ void get_raw_gyros(void)
 // Calibration routines
 //***************************************************************
 
+// Calibrate and save the gyro zeros
 void CalibrateGyrosFast(void)
+{
+	AverageGyroZeros();
+	Save_Config_to_EEPROM();
+}
+
+// Set the gyro zeros from the average of 32 reads. Not saved.
+void AverageGyroZeros(void)
 {
 	uint8_t i;
 	
@@ -248,6 +466,7 @@ void CalibrateGyrosFast(void)
 		// Calculate average over 32 reads
 		for (i = 0; i < 32; i++)
 		{
+			ReadSensors();
 			get_raw_gyros();				// Updates gyroADC_P1/P2[] with the correct orientation-based RPY
 
 			Config.gyroZero_P2[ROLL] 	+= gyroADC_P2[ROLL];
@@ -270,6 +489,7 @@ void CalibrateGyrosFast(void)
 		// Calculate average over 32 reads
 		for (i = 0; i < 32; i++)
 		{
+			ReadSensors();
 			get_raw_gyros();				// Updates gyroADC_P1/P2[] with the correct orientation-based RPY
 
 			Config.gyroZero_P1[ROLL] 	+= gyroADC_P1[ROLL];
@@ -283,8 +503,6 @@ void CalibrateGyrosFast(void)
 			Config.gyroZero_P1[i] 	= (Config.gyroZero_P1[i] >> 5);	// Divide by 32
 		}
 	}
-	
-	Save_Config_to_EEPROM();
 }
 
 bool CalibrateGyrosSlow(void)
@@ -300,7 +518,8 @@ bool CalibrateGyrosSlow(void)
 
 	// Populate Config.gyroZero[] with ballpark figures
 	// This makes slow calibrate setting much more quickly
-	CalibrateGyrosFast();	
+	// They are not saved, as the final calibration replaces them
+	AverageGyroZeros();	
 	
 	// Optimise starting point for each board
 	for (axis = 0; axis < NUMBEROFAXIS; axis++)
@@ -331,6 +550,7 @@ bool CalibrateGyrosSlow(void)
 			Gyro_timeout = 0;
 		}
 
+		ReadSensors();
 		get_raw_gyros();
 
 		// Calculate very long rolling average
@@ -368,6 +588,284 @@ bool CalibrateGyrosSlow(void)
 	return(Gyros_Stable);
 }
 
+//***************************************************************
+// Background bias tracking
+//
+// Called every loop while disarmed. Averages the gyros over windows
+// of (1 << BIAS_SHIFT) loops, starting again whenever the gyros or 
+// accs move. Each completed window becomes the new gyro zero, so 
+// the zeros follow temperature drift on the ground and are already
+// fresh when the model is armed.
+//***************************************************************
+
+void TrackGyroBias(void)
+{
+	uint8_t i;
+	bool	still = BiasRefValid;
+
+	// Check that nothing has moved since the window started
+	for (i = 0; i < NUMBEROFAXIS; i++)
+	{
+		if ((abs((gyroADC_raw[i] >> GYRODIV) - BiasGyroRef[i]) > BIAS_GYRO_STILL) ||
+			(abs(accADC[i] - BiasAccRef[i]) > BIAS_ACC_STILL))
+		{
+			still = false;
+		}
+	}
+
+	// Start a new window
+	if (!still)
+	{
+		// Old estimate can't be trusted if the model moved
+		GyroBiasFresh = false;
+
+		for (i = 0; i < NUMBEROFAXIS; i++)
+		{
+			BiasGyroRef[i] = gyroADC_raw[i] >> GYRODIV;
+			BiasAccRef[i] = accADC[i];
+			BiasSum[i] = 0;
+		}
+
+		BiasCount = 0;
+		BiasRefValid = true;
+	}
+
+	// Accumulate the same values that get_raw_gyros() produces
+	for (i = 0; i < NUMBEROFAXIS; i++)
+	{
+		BiasSum[i] += (gyroADC_raw[i] >> GYRODIV);
+	}
+
+	BiasCount++;
+
+	// Window complete
+	if (BiasCount >= (1 << BIAS_SHIFT))
+	{
+		for (i = 0; i < NUMBEROFAXIS; i++)
+		{
+			GyroBias[i] = (int16_t)((BiasSum[i] + (1 << (BIAS_SHIFT - 1))) >> BIAS_SHIFT);
+		}
+
+		GyroBiasFresh = true;
+		ApplyGyroBias();
+
+		// Keep the same reference. Drift beyond BIAS_GYRO_STILL just starts a new window.
+		for (i = 0; i < NUMBEROFAXIS; i++)
+		{
+			BiasSum[i] = 0;
+		}
+
+		BiasCount = 0;
+	}
+}
+
+// Copy the bias estimate into the zeros for both orientations.
+// The P1 and P2 zeros are the same sensor offsets in a different order.
+void ApplyGyroBias(void)
+{
+	uint8_t i;
+
+	for (i = 0; i < NUMBEROFAXIS; i++)
+	{
+		Config.gyroZero_P1[i] = GyroBias[Gyro_Orient.axis[P1][i]];
+		Config.gyroZero_P2[i] = GyroBias[Gyro_Orient.axis[P2][i]];
+	}
+}
+
+// Use the background estimate when arming instead of a blocking
+// calibration. Returns false if there isn't a fresh one.
+bool UseGyroBias(void)
+{
+	uint8_t i;
+
+	if (!GyroBiasFresh)
+	{
+		return false;
+	}
+
+	// Sanity check that the current reading agrees with the estimate
+	for (i = 0; i < NUMBEROFAXIS; i++)
+	{
+		if (abs((gyroADC_raw[i] >> GYRODIV) - GyroBias[i]) > BIAS_GYRO_STILL)
+		{
+			return false;
+		}
+	}
+
+	ApplyGyroBias();
+	Save_Config_to_EEPROM();
+
+	// Don't reuse it until the next window completes
+	GyroBiasFresh = false;
+	BiasRefValid = false;
+
+	return true;
+}
+
+//***************************************************************
+// Temperature compensation
+//
+// The MPU6050 zeros drift roughly linearly with die temperature.
+// The raw X, Y, Z readings are corrected by tempco * (temp - TempRef)
+// before anything else sees them, so the zeros stay valid while the 
+// board warms up. The coefficients are in LSB per 65536 counts of 
+// the temperature sensor (340 counts per degree C).
+//***************************************************************
+
+void TempCompensate(int16_t* vector, const int16_t* tempco)
+{
+	int32_t	temp32;
+	int32_t	delta;
+	uint8_t	i;
+
+	// Nothing to do until the coefficients have been learned
+	if (!(Config.Main_flags & (1 << tempco_done)))
+	{
+		return;
+	}
+
+	delta = (int32_t)MPU6050_temp - Config.TempRef;
+
+	for (i = 0; i < NUMBEROFAXIS; i++)
+	{
+		temp32 = vector[i] - (((int32_t)tempco[i] * delta) >> 16);
+
+		if (temp32 > INT16_MAX)
+		{
+			temp32 = INT16_MAX;
+		}
+		else if (temp32 < INT16_MIN)
+		{
+			temp32 = INT16_MIN;
+		}
+
+		vector[i] = (int16_t)temp32;
+	}
+}
+
+//***************************************************************
+// Temperature calibration
+//
+// With the board kept still, TempCoSample() is called after each 
+// ReadSensors() while the board warms or cools. Every TEMPCO_BLOCK 
+// samples, the block averages are added to a running least-squares 
+// fit of each uncompensated axis against temperature. TempCoSave()
+// stores the slopes. The zeros must be recalibrated afterwards.
+//***************************************************************
+
+void TempCoStart(void)
+{
+	memset(TempCoSum, 0, sizeof(TempCoSum));
+	memset(TempCoMean, 0, sizeof(TempCoMean));
+	memset(TempCoCov, 0, sizeof(TempCoCov));
+
+	TempCoSamples = 0;
+	TempCoPoints = 0;
+	TempCoMin = INT16_MAX;
+	TempCoMax = INT16_MIN;
+}
+
+void TempCoSample(void)
+{
+	uint8_t i;
+	int16_t temperature;
+	float	average;
+	float	delta;
+
+	// Accumulate the uncompensated X, Y, Z readings as they come from the MPU6050
+	for (i = 0; i < NUMBEROFAXIS; i++)
+	{
+		TempCoSum[i] += (int16_t)((SensorSample[SENSOR_GYRO + (i << 1)] << 8) + SensorSample[SENSOR_GYRO + (i << 1) + 1]);
+		TempCoSum[i + NUMBEROFAXIS] += (int16_t)((SensorSample[SENSOR_ACC + (i << 1)] << 8) + SensorSample[SENSOR_ACC + (i << 1) + 1]);
+	}
+
+	TempCoSum[TEMPCO_TEMP] += MPU6050_temp;
+	TempCoSamples++;
+
+	if (TempCoSamples < TEMPCO_BLOCK)
+	{
+		return;
+	}
+
+	// Track the temperature range covered
+	temperature = (int16_t)(TempCoSum[TEMPCO_TEMP] / TEMPCO_BLOCK);
+
+	if (temperature < TempCoMin)
+	{
+		TempCoMin = temperature;
+	}
+
+	if (temperature > TempCoMax)
+	{
+		TempCoMax = temperature;
+	}
+
+	// Add the block to the fit. Updating the means and co-moments
+	// incrementally avoids the cancellation of large float sums.
+	TempCoPoints++;
+	delta = ((float)TempCoSum[TEMPCO_TEMP] / TEMPCO_BLOCK) - TempCoMean[TEMPCO_TEMP];
+
+	for (i = 0; i < TEMPCO_CHANNELS; i++)
+	{
+		average = (float)TempCoSum[i] / TEMPCO_BLOCK;
+		TempCoMean[i] += (average - TempCoMean[i]) / TempCoPoints;
+		TempCoCov[i] += delta * (average - TempCoMean[i]);
+		TempCoSum[i] = 0;
+	}
+
+	TempCoSamples = 0;
+}
+
+// Temperature range covered so far in sensor counts
+int16_t TempCoSpan(void)
+{
+	if (TempCoPoints == 0)
+	{
+		return 0;
+	}
+
+	return (TempCoMax - TempCoMin);
+}
+
+// Slope of one channel against temperature, scaled by 65536
+int16_t TempCoCoefficient(uint8_t channel)
+{
+	float slope;
+
+	if (TempCoCov[TEMPCO_TEMP] <= 0)
+	{
+		return 0;
+	}
+
+	slope = (TempCoCov[channel] / TempCoCov[TEMPCO_TEMP]) * 65536.0f;
+
+	if (slope > INT16_MAX)
+	{
+		slope = INT16_MAX;
+	}
+	else if (slope < INT16_MIN)
+	{
+		slope = INT16_MIN;
+	}
+
+	return (int16_t)slope;
+}
+
+// Store the coefficients, referenced to the current temperature
+void TempCoSave(void)
+{
+	uint8_t i;
+
+	for (i = 0; i < NUMBEROFAXIS; i++)
+	{
+		Config.GyroTempCo[i] = TempCoCoefficient(i);
+		Config.AccTempCo[i] = TempCoCoefficient(i + NUMBEROFAXIS);
+	}
+
+	Config.TempRef = MPU6050_temp;
+	Config.Main_flags |= (1 << tempco_done);
+}
+
 //***************************************************************
 // Set up the MPU6050 (Gyro)
 //***************************************************************
@@ -380,10 +878,48 @@ void init_i2c_gyros(void)
 	// Make INT pin open-drain so that we can connect it straight to the MPU
 	writeI2Cbyte(MPU60X0_DEFAULT_ADDRESS, MPU60X0_RA_INT_PIN_CFG, 0x40);			// INT output is open-drain
 	
-	// MPU6050's internal LPF. Values are 0x06 = 5Hz, (5)10Hz, (4)21Hz, (3)44Hz, (2)94Hz, (1)184Hz LPF, (0)260Hz
-	// Software's values are 0 to 6 = 5Hz to 260Hz, so numbering is reversed here.
-	writeI2Cbyte(MPU60X0_DEFAULT_ADDRESS, MPU60X0_RA_CONFIG, (6 - Config.MPU6050_LPF));
+	// Set the LPF and sample rate
+	init_i2c_lpf();
 	
+#ifdef DATA_READY_SYNC
+	// Flag each new sample in INT_STATUS
+	writeI2Cbyte(MPU60X0_DEFAULT_ADDRESS, MPU60X0_RA_INT_ENABLE, MPU60X0_INTERRUPT_DATA_RDY);
+#endif
+
 	// Now configure gyros
 	writeI2Cbyte(MPU60X0_DEFAULT_ADDRESS, MPU60X0_RA_GYRO_CONFIG, GYROFS2000DEG);	// 2000 deg/sec
+
+#ifdef GYRO_FIFO
+	// Queue every gyro sample in the FIFO
+	writeI2Cbyte(MPU60X0_DEFAULT_ADDRESS, MPU60X0_RA_FIFO_EN, ((1 << MPU60X0_XG_FIFO_EN_BIT) | (1 << MPU60X0_YG_FIFO_EN_BIT) | (1 << MPU60X0_ZG_FIFO_EN_BIT)));
+	ResetGyroFIFO();
+#endif
+}
+
+//***************************************************************
+// Set the MPU6050 LPF. The gyro output rate is 8kHz with the LPF 
+// at 260Hz and 1kHz otherwise, so the sample rate divider has to 
+// be updated with it.
+//***************************************************************
+
+void init_i2c_lpf(void)
+{
+	// Work out the LPFs to suit the loop rate
+	UpdateFilters();
+
+	// MPU6050's internal LPF. Values are 0x06 = 5Hz, (5)10Hz, (4)21Hz, (3)44Hz, (2)94Hz, (1)184Hz LPF, (0)260Hz
+	// Software's values are 0 to 6 = 5Hz to 260Hz, so numbering is reversed here.
+	writeI2Cbyte(MPU60X0_DEFAULT_ADDRESS, MPU60X0_RA_CONFIG, (6 - MPU6050_LPF_hw));
+
+#if defined(DATA_READY_SYNC) || defined(GYRO_FIFO)
+	// Sample rate = Gyro output rate / (1 + SMPLRT_DIV)
+	if (MPU6050_LPF_hw == HZ260)
+	{
+		writeI2Cbyte(MPU60X0_DEFAULT_ADDRESS, MPU60X0_RA_SMPLRT_DIV, ((8000 / SENSOR_RATE) - 1));
+	}
+	else
+	{
+		writeI2Cbyte(MPU60X0_DEFAULT_ADDRESS, MPU60X0_RA_SMPLRT_DIV, ((1000 / SENSOR_RATE) - 1));
+	}
+#endif
 }
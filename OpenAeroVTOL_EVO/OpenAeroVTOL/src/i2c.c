@@ -7,36 +7,373 @@
 //***********************************************************
 
 #include <avr/io.h>
+#include <avr/interrupt.h>
+#include <stdbool.h>
+#include <string.h>
+#include <compat/twi.h>
 #include "io_cfg.h"
 #include "i2cmaster.h"
 #include "compiledefs.h"
+#include "MPU6050.h"
+#include "i2c.h"
+#include "isr.h"
 
 //************************************************************
 // Prototypes
 //************************************************************
 
-void writeI2Cbyte(uint8_t address, uint8_t location, uint8_t value);
-void readI2CbyteArray(uint8_t address, uint8_t location, uint8_t *array,uint8_t size);
+bool writeI2Cbyte(uint8_t address, uint8_t location, uint8_t value);
+bool readI2CbyteArray(uint8_t address, uint8_t location, uint8_t *array,uint8_t size);
+void readI2CbyteArrayAsync(uint8_t address, uint8_t location, uint8_t *array,uint8_t size);
+bool waitI2Casync(void);
+void StartSensorRead(void);
+void WaitSensorReady(void);
+void ReadSensors(void);
+void ReadGyroFIFO(void);
+void ResetGyroFIFO(void);
+void RecoverI2C(void);
+
+//************************************************************
+// Defines
+//************************************************************
+
+#define I2C_ASYNC_TIMEOUT 40		// Background transfer timeout in T2 ticks. 40 * 1/19531 = 2ms
+
+#define FIFO_SAMPLE_SIZE 6			// Gyro X, Y, Z per FIFO sample
+#define FIFO_CHUNK 8				// Samples read per I2C transaction
+#define FIFO_MAX_SAMPLES 24			// Most samples averaged per loop. Any more and the FIFO is reset.
+
+#define I2C_RECOVERY_HOLDOFF 50		// Sensor reads skipped after a failed bus recovery
+
+// TWCR settings for each step of a background transfer
+#define TWCR_START	((1 << TWINT) | (1 << TWSTA) | (1 << TWEN) | (1 << TWIE))
+#define TWCR_NEXT	((1 << TWINT) | (1 << TWEN) | (1 << TWIE))
+#define TWCR_ACK	((1 << TWINT) | (1 << TWEN) | (1 << TWIE) | (1 << TWEA))
+#define TWCR_STOP	((1 << TWINT) | (1 << TWEN) | (1 << TWSTO))
 
 //************************************************************
 // Code
 //************************************************************
 
-void writeI2Cbyte(uint8_t address, uint8_t location, uint8_t value)
+uint8_t SensorSample[SENSOR_SAMPLE_SIZE];	// Raw MPU6050 data, ACCEL_XOUT_H to GYRO_ZOUT_L
+uint8_t SensorBuffer[SENSOR_SAMPLE_SIZE];	// Incoming sample. Only copied to SensorSample[] if read correctly.
+int16_t MPU6050_temp;						// Raw MPU6050 temperature from the same sample
+uint16_t I2C_Errors;						// Failed sensor reads
+uint8_t I2C_Holdoff;						// Sensor reads to skip before the next recovery attempt
+
+volatile i2c_transfer_t I2C_Transfer;		// Current background transfer
+
+//************************************************************
+// TWI interrupt. Steps through a background register read:
+// START, SLA+W, register, repeated START, SLA+R, data..., STOP
+//************************************************************
+
+ISR(TWI_vect)
+{
+	// Log interrupts that occur during PWM generation
+	if (JitterGate)	JitterFlag = true;
+
+	switch (TW_STATUS)
+	{
+		case TW_START:
+			TWDR = I2C_Transfer.address + I2C_WRITE;
+			TWCR = TWCR_NEXT;
+			break;
+
+		case TW_MT_SLA_ACK:
+			TWDR = I2C_Transfer.location;		// Set up register address
+			TWCR = TWCR_NEXT;
+			break;
+
+		case TW_MT_DATA_ACK:
+			TWCR = TWCR_START;					// Repeated start
+			break;
+
+		case TW_REP_START:
+			TWDR = I2C_Transfer.address + I2C_READ;
+			TWCR = TWCR_NEXT;
+			break;
+
+		case TW_MR_DATA_ACK:
+			I2C_Transfer.buffer[I2C_Transfer.index++] = TWDR;
+			// Fall through
+
+		case TW_MR_SLA_ACK:
+			// ACK all but the last byte
+			if ((I2C_Transfer.index + 1) < I2C_Transfer.size)
+			{
+				TWCR = TWCR_ACK;
+			}
+			else
+			{
+				TWCR = TWCR_NEXT;
+			}
+			break;
+
+		case TW_MR_DATA_NACK:
+			I2C_Transfer.buffer[I2C_Transfer.index++] = TWDR;
+			TWCR = TWCR_STOP;
+			I2C_Transfer.state = I2C_DONE;
+			break;
+
+		// NACKs, arbitration lost or bus errors
+		default:
+			TWCR = TWCR_STOP;
+			I2C_Transfer.state = I2C_ERROR;
+			break;
+	}
+}
+
+// Start reading a block of registers in the background.
+// Completion is signalled in I2C_Transfer.state.
+void readI2CbyteArrayAsync(uint8_t address, uint8_t location, uint8_t *array,uint8_t size)
+{
+	// Don't disturb a transfer already in progress
+	if (I2C_Transfer.state == I2C_BUSY)
+	{
+		return;
+	}
+	
+	I2C_Transfer.address = address;
+	I2C_Transfer.location = location;
+	I2C_Transfer.buffer = array;
+	I2C_Transfer.size = size;
+	I2C_Transfer.index = 0;
+	I2C_Transfer.state = I2C_BUSY;
+
+	TWCR = TWCR_START;
+}
+
+// Wait for any background transfer to finish. A stalled transfer is
+// abandoned after I2C_ASYNC_TIMEOUT. Returns true if new data arrived.
+bool waitI2Casync(void)
+{
+	uint8_t	Start_TCNT2 = TCNT2;
+	uint8_t state;
+
+	while ((I2C_Transfer.state == I2C_BUSY) && ((uint8_t)(TCNT2 - Start_TCNT2) < I2C_ASYNC_TIMEOUT));
+
+	// Timed out. Release the bus and stop TWI interrupts.
+	if (I2C_Transfer.state == I2C_BUSY)
+	{
+		TWCR = TWCR_STOP;
+		I2C_Transfer.state = I2C_ERROR;
+	}
+
+	state = I2C_Transfer.state;
+	I2C_Transfer.state = I2C_IDLE;
+
+	return (state == I2C_DONE);
+}
+
+#ifdef DATA_READY_SYNC
+// Wait for the MPU6050 to flag a new sample so that each loop works on
+// fresh data at a fixed rate. Gives up after two sample periods so that
+// a missed flag can't stall the loop.
+void WaitSensorReady(void)
+{
+	uint8_t	Start_TCNT2 = TCNT2;
+	uint8_t status = 0;
+
+	// Reading INT_STATUS clears the flag
+	while (!(status & MPU60X0_INTERRUPT_DATA_RDY) && ((uint8_t)(TCNT2 - Start_TCNT2) < SENSOR_READY_TIMEOUT))
+	{
+		readI2CbyteArray(MPU60X0_DEFAULT_ADDRESS, MPU60X0_RA_INT_STATUS, &status, 1);
+	}
+}
+#endif
+
+// Start the next sensor sample in the background so that the bus time
+// can be spent on other work. ReadSensors() collects it.
+void StartSensorRead(void)
+{
+	// Don't start a read that will probably fail
+	if (I2C_Holdoff > 0)
+	{
+		return;
+	}
+
+	readI2CbyteArrayAsync(MPU60X0_DEFAULT_ADDRESS, MPU60X0_RA_ACCEL_XOUT_H, SensorBuffer, SENSOR_SAMPLE_SIZE);
+}
+
+// Read the accs, temperature and gyros in one transaction.
+// The registers are contiguous, so this is one START and register write
+// instead of two, and the acc and gyro data come from the same instant.
+// If StartSensorRead() was called, use that data instead.
+// If the read fails, the last good sample is kept and the bus is recovered.
+void ReadSensors(void)
+{
+	bool good = false;
+
+	// A recovery has failed. Keep the last good sample without touching 
+	// the bus until it is time to try again.
+	if (I2C_Holdoff > 0)
+	{
+		I2C_Holdoff--;
+		return;
+	}
+
+	// Collect the background transfer if there is one
+	if (I2C_Transfer.state != I2C_IDLE)
+	{
+		good = waitI2Casync();
+	}
+
+	// Otherwise, or if it failed, do a normal read
+	if (!good)
+	{
+		good = readI2CbyteArray(MPU60X0_DEFAULT_ADDRESS, MPU60X0_RA_ACCEL_XOUT_H, SensorBuffer, SENSOR_SAMPLE_SIZE);
+	}
+
+	if (good)
+	{
+		memcpy(SensorSample, SensorBuffer, SENSOR_SAMPLE_SIZE);
+	}
+	else
+	{
+		RecoverI2C();
+		return;
+	}
+
+	MPU6050_temp = (SensorSample[SENSOR_TEMP] << 8) + SensorSample[SENSOR_TEMP + 1];
+
+#ifdef GYRO_FIFO
+	// Replace the gyro data with the average of the FIFO samples
+	ReadGyroFIFO();
+#endif
+}
+
+// Free a stuck bus and set up the MPU6050 again in case it was reset.
+// Each step is time-limited, so this costs at most a few ms and the 
+// servo outputs keep running. If the sensor still can't be read, the
+// next I2C_RECOVERY_HOLDOFF reads are skipped so that a dead sensor 
+// can't slow every loop.
+void RecoverI2C(void)
+{
+	I2C_Errors++;
+
+	i2c_recover();
+	init_i2c_gyros();
+	init_i2c_accs();
+
+	if (!readI2CbyteArray(MPU60X0_DEFAULT_ADDRESS, MPU60X0_RA_ACCEL_XOUT_H, SensorBuffer, SENSOR_SAMPLE_SIZE))
+	{
+		I2C_Holdoff = I2C_RECOVERY_HOLDOFF;
+	}
+}
+
+#ifdef GYRO_FIFO
+// Drain the gyro samples queued in the MPU6050 FIFO since the last call
+// and average them. Averaging every sample acts as a decimating 
+// anti-alias filter, and motion between loops still reaches the I-terms.
+// The result replaces the gyro data in SensorSample[].
+void ReadGyroFIFO(void)
+{
+	uint8_t		buffer[FIFO_CHUNK * FIFO_SAMPLE_SIZE];
+	int32_t		sum[NUMBEROFAXIS] = {0,0,0};
+	uint16_t	count;
+	uint8_t		samples, chunk, total = 0;
+	uint8_t		i, j;
+	int16_t		temp;
+
+	if (!readI2CbyteArray(MPU60X0_DEFAULT_ADDRESS, MPU60X0_RA_FIFO_COUNTH, buffer, 2))
+	{
+		return;
+	}
+
+	count = (buffer[0] << 8) + buffer[1];
+
+	// Out of step, or a long pass has left more samples than can be read here.
+	// Start again and keep the direct gyro data, which is the newest sample.
+	// Averaging the oldest samples would leave the gyro running late.
+	// This also covers an overflowed FIFO.
+	if ((count % FIFO_SAMPLE_SIZE) || (count > (FIFO_MAX_SAMPLES * FIFO_SAMPLE_SIZE)))
+	{
+		ResetGyroFIFO();
+		return;
+	}
+
+	samples = count / FIFO_SAMPLE_SIZE;
+
+	while (samples > 0)
+	{
+		chunk = (samples > FIFO_CHUNK) ? FIFO_CHUNK : samples;
+		
+		// Give up on a failed read. Its data and position in the FIFO can't be trusted.
+		if (!readI2CbyteArray(MPU60X0_DEFAULT_ADDRESS, MPU60X0_RA_FIFO_R_W, buffer, (chunk * FIFO_SAMPLE_SIZE)))
+		{
+			ResetGyroFIFO();
+			return;
+		}
+
+		for (i = 0; i < chunk; i++)
+		{
+			for (j = 0; j < NUMBEROFAXIS; j++)
+			{
+				temp = (buffer[(i * FIFO_SAMPLE_SIZE) + (j * 2)] << 8) + buffer[(i * FIFO_SAMPLE_SIZE) + (j * 2) + 1];
+				sum[j] += temp;
+			}
+		}
+
+		samples -= chunk;
+		total += chunk;
+	}
+
+	// Nothing new, so keep the direct gyro data
+	if (total == 0)
+	{
+		return;
+	}
+
+	// Store the averages in the same format as the MPU6050 registers
+	for (j = 0; j < NUMBEROFAXIS; j++)
+	{
+		temp = sum[j] / total;
+		SensorSample[SENSOR_GYRO + (j * 2)] = (uint8_t)(temp >> 8);
+		SensorSample[SENSOR_GYRO + (j * 2) + 1] = (uint8_t)temp;
+	}
+}
+
+// Empty the FIFO and restart it
+void ResetGyroFIFO(void)
 {
-    i2c_start_wait(address+I2C_WRITE);				// Set up device address 
-    i2c_write(location);							// Set up register address 
-    i2c_write(value); 								// Write byte
+	writeI2Cbyte(MPU60X0_DEFAULT_ADDRESS, MPU60X0_RA_USER_CTRL, ((1 << MPU60X0_USERCTRL_FIFO_EN_BIT) | (1 << MPU60X0_USERCTRL_FIFO_RESET_BIT)));
+}
+#endif
+
+// Returns true if successful
+bool writeI2Cbyte(uint8_t address, uint8_t location, uint8_t value)
+{
+	waitI2Casync();									// Let any background transfer finish
+	i2c_error = 0;
+
+    if (i2c_start_wait(address+I2C_WRITE) == 0)		// Set up device address 
+	{
+		i2c_write(location);						// Set up register address 
+		i2c_write(value); 							// Write byte
+	}
+
     i2c_stop();
+
+	return (i2c_error == 0);
 }
 
-void readI2CbyteArray(uint8_t address, uint8_t location, uint8_t *array,uint8_t size)
+// Returns true if successful
+bool readI2CbyteArray(uint8_t address, uint8_t location, uint8_t *array,uint8_t size)
 {
 	int i=0;
 
-    i2c_start_wait(address+I2C_WRITE);
-    i2c_write(location);							// Set up register address 
-    i2c_rep_start(address+I2C_READ);
+	waitI2Casync();									// Let any background transfer finish
+	i2c_error = 0;
+
+	// Don't carry on with a device that isn't answering
+    if ((i2c_start_wait(address+I2C_WRITE) != 0) ||
+		(i2c_write(location) != 0) ||				// Set up register address 
+		(i2c_rep_start(address+I2C_READ) != 0))
+	{
+		i2c_stop();
+		return false;
+	}
 
 	while (i < size)
 	{
@@ -52,6 +389,8 @@ void readI2CbyteArray(uint8_t address, uint8_t location, uint8_t *array,uint8_t
 	}
 
     i2c_stop();
+
+	return (i2c_error == 0);
 }
 
 
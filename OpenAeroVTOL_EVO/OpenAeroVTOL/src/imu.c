@@ -25,6 +25,7 @@
 #include "menu_ext.h"
 #include "rc.h"
 #include "isr.h"
+#include "i2c.h"
 
 //************************************************************
 // IMU Prototypes
@@ -40,6 +41,9 @@ float thetascale(float gyro, float intervalf);
 void RotateVector(float angle);
 float ext2(float Vector);
 void reset_IMU(void);
+float LimitBias(float bias);
+void UpdateFilters(void);
+void SetLPF(lpf_t* lpf, int8_t setting, uint16_t loop_rate);
 
 //************************************************************
 // 	Defines
@@ -65,6 +69,15 @@ void reset_IMU(void);
 
 #define ZACCLPF				64.0f		// In HS mode, 256.0 would be about 0.4Hz
 
+#define IMU_BIAS_RATE		0.02f		// Fraction of the acc correction learnt as gyro bias per second
+#define IMU_BIAS_LIMIT		1.5f		// Largest learnt gyro bias (about 1.5 deg/s at 0.977 deg/s/lsb).
+										// Drift left after the disarmed zero tracking is well under this. A larger
+										// limit would let a slow real turn be learnt as bias and cancelled out.
+
+#define LOOP_RATE_NORMAL	700			// Approximate loop rate (Hz) when Servo_rate is LOW or SYNC
+#define LOOP_RATE_FAST		250			// Approximate loop rate (Hz) when Servo_rate is FAST
+#define TWO_PI				6.283185f
+
 
 //************************************************************
 // 	Globals
@@ -78,6 +91,7 @@ float VectorZ = 1;
 
 float VectorNewA, VectorNewB;
 float GyroPitchVC, GyroRollVC, GyroYawVC;
+float GyroRollBias, GyroPitchBias;		// Gyro bias learnt from the accs while armed
 float AccAnglePitch, AccAngleRoll, EulerAngleRoll, EulerAnglePitch;
 
 float		intervalf;					// Interval in seconds since the last loop
@@ -86,9 +100,12 @@ float 	accSmooth[NUMBEROFAXIS];		// Filtered acc data
 //float	accVertZerof;					// Long-term Z acc average
 int16_t	angle[2];						// Attitude in degrees - pitch and roll
 	
-// Software LPF conversion table 5Hz, 10Hz, 21Hz, 44Hz, 94Hz, 184Hz, 260Hz, None	
-const float LPF_lookup[8] PROGMEM		= {23.0,11.58,5.85,3.1,1.82,1.35,1.24,1.0};	// 700Hz (All settings usable)
-const float LPF_lookup_HS[8] PROGMEM	= {8.53,4.53,2.49,1.58,1.24,1.0,1.0,1.0};	// 250Hz (Cannot use 184Hz, 260Hz settings)
+// LPF cut-off frequencies for 5Hz, 10Hz, 21Hz, 44Hz, 94Hz, 184Hz, 260Hz
+const uint16_t LPF_cutoff[NOFILTER] PROGMEM = {5,10,21,44,94,184,260};
+
+lpf_t	AccLPF;							// Software acc LPF
+lpf_t	GyroLPF;						// Software gyro LPF
+int8_t	MPU6050_LPF_hw;					// MPU6050 LPF actually in use
 	
 //************************************************************
 // Code
@@ -135,25 +152,16 @@ void imu_update(uint32_t period)
 	// Acc LPF
 	//************************************************************	
 
-	// Note: Two sets of values for normal and high-speed mode
-	if (Config.Servo_rate != FAST)
-	{
-		memcpy_P(&tempf, &LPF_lookup[Config.Acc_LPF], sizeof(float));
-	}
-	else
-	{
-		memcpy_P(&tempf, &LPF_lookup_HS[Config.Acc_LPF], sizeof(float));
-	}
-	
+	// Coefficients come from UpdateFilters()
 	// Smooth Acc signals - note that accSmooth is in [ROLL, PITCH, YAW] order
 	for (axis = 0; axis < NUMBEROFAXIS; axis++)
 	{
 		accADCf = accADC[axis]; // Promote
 		
 		// Acc LPF
-		if (Config.Acc_LPF != NOFILTER)
+		if (AccLPF.gain < 1.0f)
 		{
-			accSmooth[axis] = ((accSmooth[axis] * (tempf - 1.0f)) - accADCf) / tempf;
+			accSmooth[axis] = (accSmooth[axis] * AccLPF.keep) - (accADCf * AccLPF.gain);
 		}
 		else
 		{
@@ -198,8 +206,21 @@ void imu_update(uint32_t period)
 		tempf = (EulerAnglePitch - AccAnglePitch) / 10;
 		tempf = tempf * (12 - Config.CF_factor);
 		GyroPitchVC = GyroPitchVC + tempf;
+
+		// Slowly learn any remaining gyro bias from the same correction.
+		// The gyro zeros are tracked separately while disarmed.
+		if (!(General_error & (1 << DISARMED)))
+		{
+			tempf = IMU_BIAS_RATE * intervalf * (12 - Config.CF_factor) / 10;
+			GyroRollBias = LimitBias(GyroRollBias + ((EulerAngleRoll - AccAngleRoll) * tempf));
+			GyroPitchBias = LimitBias(GyroPitchBias + ((EulerAnglePitch - AccAnglePitch) * tempf));
+		}
 	}
 
+	// Remove the learnt bias
+	GyroRollVC = GyroRollVC + GyroRollBias;
+	GyroPitchVC = GyroPitchVC + GyroPitchBias;
+
 	// Rotate up-direction 3D vector with gyro inputs
 	Rotate3dVector(intervalf);
 	ExtractEulerAngles();
@@ -334,9 +355,92 @@ void reset_IMU(void)
 	VectorB = 0;
 	EulerAngleRoll = 0;
 	EulerAnglePitch = 0;
+	
+	// Forget the learnt gyro bias
+	GyroRollBias = 0;
+	GyroPitchBias = 0;
 
 	// Reset loop count to zero
 	TMR0_counter = 0;	// TMR0 overflow counter
 	TCNT1 = 0;			// TCNT1 current time
 	LoopStartTCNT1 = 0;	// TCNT1 last loop time
 }
+
+// Keep the learnt gyro bias within IMU_BIAS_LIMIT
+float LimitBias(float bias)
+{
+	if (bias > IMU_BIAS_LIMIT)
+	{
+		bias = IMU_BIAS_LIMIT;
+	}
+	
+	if (bias < -IMU_BIAS_LIMIT)
+	{
+		bias = -IMU_BIAS_LIMIT;
+	}
+	
+	return bias;
+}
+
+//************************************************************
+// Filter set-up
+//
+// Called whenever the settings change. The MPU6050's LPF is 
+// kept below half the loop rate so that it does the anti-aliasing
+// for free. A software LPF is only run if it cuts lower than the
+// MPU6050 already does, with its coefficients worked out here 
+// for the loop rate rather than looked up every loop.
+//************************************************************
+
+void UpdateFilters(void)
+{
+	uint16_t loop_rate;
+
+	// Loop rate for the current servo rate
+	if (Config.Servo_rate == FAST)
+	{
+		loop_rate = LOOP_RATE_FAST;
+	}
+	else
+	{
+		loop_rate = LOOP_RATE_NORMAL;
+	}
+
+#ifdef DATA_READY_SYNC
+	// The loop can't run faster than the MPU6050 samples
+	if (loop_rate > SENSOR_RATE)
+	{
+		loop_rate = SENSOR_RATE;
+	}
+#endif
+
+	// Drop the MPU6050 LPF until it is below the Nyquist frequency
+	MPU6050_LPF_hw = Config.MPU6050_LPF;
+
+	while ((MPU6050_LPF_hw > HZ5) && (pgm_read_word(&LPF_cutoff[MPU6050_LPF_hw]) > (loop_rate >> 1)))
+	{
+		MPU6050_LPF_hw--;
+	}
+
+	SetLPF(&AccLPF, Config.Acc_LPF, loop_rate);
+	SetLPF(&GyroLPF, Config.Gyro_LPF, loop_rate);
+}
+
+// Work out a single-pole LPF for the loop rate, or bypass it if the MPU6050 is already tighter
+void SetLPF(lpf_t* lpf, int8_t setting, uint16_t loop_rate)
+{
+	float divisor;
+
+	if (setting >= MPU6050_LPF_hw)
+	{
+		lpf->keep = 0.0f;
+		lpf->gain = 1.0f;
+		return;
+	}
+
+	// Divisor for the filter's time constant in loops
+	divisor = 1.0f + ((float)loop_rate / (TWO_PI * pgm_read_word(&LPF_cutoff[setting])));
+
+	lpf->gain = 1.0f / divisor;
+	lpf->keep = 1.0f - lpf->gain;
+}
@@ -190,9 +190,23 @@ void init(void)
 	// Preset important flags
 	Interrupted = false;						
 
+	// Time to armable on a clean boot with the board still, counted from the code here:
+	// 63ms satellite wait, about 2ms to read and check the newest bank, 300ms LCD settle,
+	// 1000ms logo, about 60ms of full LCD writes, at least 201 gyro samples (about 0.3s),
+	// the 25ms beep and up to 0.3s of ESC pulses. About 2.1s, nearly all deliberate delays.
+	// Keep the eeprom part to a few ms. Settings that haven't changed are not saved again.
+
 	// Load EEPROM settings
 	updated = Initial_EEPROM_Config_Load(); // Config now contains valid values
 
+	#ifdef ERROR_LOG
+	// Find where the event log journal got to
+	Init_EEPROM_log();
+	#endif
+
+	// Compile the board orientation before the sensors are first read
+	UpdateOrientation();
+
 	//***********************************************************
 	// RX channel defaults for when no RC connected
 	// Not doing this can result in the FC trying (unsuccessfully) to arm
@@ -351,8 +365,8 @@ void init(void)
 		
 	// Do startup tasks
 	Init_ADC();
+	init_uart();							// Initialise UART first so the serial decoder is set before RX interrupts start
 	init_int();								// Initialise interrupts based on RC input mode
-	init_uart();							// Initialise UART
 
 	// Initial gyro calibration
 	if (!CalibrateGyrosSlow())
@@ -370,7 +384,7 @@ void init(void)
 
 	// Update voltage detection
 	SystemVoltage = GetVbat();				// Check power-up battery voltage
-	UpdateLimits();							// Update travel and trigger limits
+	UpdateLimits();							// Update travel and trigger limits. Only saves if something changed.
 
 	// Disarm on start-up if Armed setting is ARMABLE
 	if (Config.ArmMode == ARMABLE)
@@ -22,6 +22,14 @@ uint16_t TIM16_ReadTCNT1(void);
 void init_int(void);
 void Disable_RC_Interrupts(void);
 
+bool Decode_Xtreme(uint8_t temp);
+bool Decode_SBus(uint8_t temp);
+bool Decode_Spektrum(uint8_t temp);
+bool Decode_ModeB(uint8_t temp);
+bool Decode_SUMD(uint8_t temp);
+bool Decode_IBus(uint8_t temp);
+bool Decode_CRSF(uint8_t temp);
+
 //************************************************************
 // Interrupt vectors
 //************************************************************
@@ -29,6 +37,7 @@ void Disable_RC_Interrupts(void);
 volatile bool Interrupted;			// Flag that RX packet completed
 volatile bool JitterFlag;			// Flag that interrupt occurred
 volatile bool JitterGate;			// Area when we care about JitterFlag
+volatile bool RxFrameReady;			// Flag that new RC data is available for interpolation
 
 volatile uint16_t RxChannel[MAX_RC_CHANNELS];
 volatile uint16_t RxChannelStart[MAX_RC_CHANNELS];	
@@ -44,6 +53,14 @@ volatile uint8_t bytecount;
 volatile uint16_t TMR0_counter;		// Number of times Timer 0 has overflowed
 volatile uint16_t FrameRate;		// Updated frame rate for serial packets
 volatile uint8_t packet_size;
+volatile rx_stats_t RxStats;		// RC link statistics
+volatile uint8_t RxChannelFresh;	// RxChannel[] entries updated since last read, one bit each
+volatile uint8_t SpektrumFormat;	// Detected Spektrum resolution and frame period
+
+uint16_t SpektrumMask10;			// Channel numbers seen if 10-bit data
+uint16_t SpektrumMask11;			// Channel numbers seen if 11-bit data
+uint8_t SpektrumGuess;				// Frames gathered for resolution detection
+uint16_t SpektrumLastFrame;			// Timestamp of the last Spektrum frame
 
 #define SYNCPULSEWIDTH 6750			// CPPM sync pulse must be more than 2.7ms
 #define MINPULSEWIDTH 750			// Minimum CPPM pulse is 300us
@@ -59,6 +76,16 @@ volatile uint8_t packet_size;
 #define XBUS_CRC_BYTE_2 26
 #define XBUS_CRC_AND_VALUE 0x8000
 #define XBUS_CRC_POLY 0x1021
+#define IBUS_FRAME_SIZE 32			// IBUS packet size
+#define IBUS_COMMAND_SERVO 0x40		// IBUS servo data command
+#define CRSF_MAX_FRAME 64			// Maximum possible CRSF packet size
+#define CRSF_FRAME_RC_CHANNELS 0x16	// CRSF packed RC channels frame type
+#define SPEKTRUM_GUESS_FRAMES 4		// Frames gathered before deciding the Spektrum resolution
+#define SPEKTRUM_MIN_CHANNELS 5		// Fewest channels a Spektrum transmitter sends
+#define SPEKTRUM_11MS_MIN 22500		// 9ms
+#define SPEKTRUM_11MS_MAX 32500		// 13ms
+#define SPEKTRUM_22MS_MIN 50000		// 20ms
+#define SPEKTRUM_22MS_MAX 60000		// 24ms
 			
 //************************************************************
 //* Timer 0 overflow handler for extending TMR1
@@ -72,98 +99,96 @@ ISR(TIMER0_OVF_vect)
 //************************************************************
 //* Standard PWM mode
 //* Sequential PWM inputs from a normal RC receiver
+//*
+//* All five PWM inputs use pin-change interrupts. Each port
+//* vector latches TCNT1 once, then XORs the port against the
+//* previous snapshot so that simultaneous edges are handled
+//* in a single pass through PWM_Edges().
 //************************************************************
 
-ISR(INT1_vect)
-{
-	// Log interrupts that occur during PWM generation
-	if (JitterGate)	JitterFlag = true;	
+#define PWM_PORTB_MASK ((1 << PINB0) | (1 << PINB2))					// GEAR, RUDDER
+#define PWM_PORTD_MASK ((1 << PIND0) | (1 << PIND2) | (1 << PIND3))	// THROTTLE, ELEVATOR, AILERON
+#define PWM_PINS 4					// Only bits 0 to 3 of each port carry RC inputs
+#define PWM_NOPIN 0xFF				// Pin is not an RC input
 
-	if (RX_ROLL)	// Rising
-	{
-		RxChannelStart[AILERON] = TCNT1;
-	} 
-	else 
-	{				// Falling
-		RxChannel[AILERON] = TCNT1 - RxChannelStart[AILERON];
-		if (Config.PWM_Sync == AILERON) 
-		{
-			Interrupted = true;						// Signal that interrupt block has finished
-			Servo_TCNT2 = TCNT2;					// Reset signal loss timer and Overdue state 
-			RC_Timeout = 0;
-			Overdue = false;
-		}
-	}
-}
+const uint8_t PWM_PortB_Chan[PWM_PINS] = {GEAR, PWM_NOPIN, RUDDER, PWM_NOPIN};
+const uint8_t PWM_PortD_Chan[PWM_PINS] = {THROTTLE, PWM_NOPIN, ELEVATOR, AILERON};
 
-ISR(INT0_vect)
-{
-	if (JitterGate)	JitterFlag = true;	
+volatile uint8_t PWM_PortB_Old;		// Last RC input pin states
+volatile uint8_t PWM_PortD_Old;
 
-	if (RX_PITCH)	// Rising 
+static inline void PWM_Edges(uint8_t changed, uint8_t pins, const uint8_t* chan_map, uint16_t tCount)
+{
+	uint8_t i;
+	uint8_t chan;
+	
+	// Walk the changed bits until none are left
+	for (i = 0; changed; i++)
 	{
-		RxChannelStart[ELEVATOR] = TCNT1;
-	} 
-	else 
-	{				// Falling
-		RxChannel[ELEVATOR] = TCNT1 - RxChannelStart[ELEVATOR];
-		if (Config.PWM_Sync == ELEVATOR) 
+		if (changed & 1)
 		{
-			Interrupted = true;						// Signal that interrupt block has finished
-			Servo_TCNT2 = TCNT2;					// Reset signal loss timer and Overdue state 
-			RC_Timeout = 0;
-			Overdue = false;
+			chan = chan_map[i];
+			
+			if (pins & 1)	// Rising
+			{
+				RxChannelStart[chan] = tCount;
+			}
+			else
+			{				// Falling
+				RxChannel[chan] = tCount - RxChannelStart[chan];
+				if (Config.PWM_Sync == chan)
+				{
+					Interrupted = true;				// Signal that interrupt block has finished
+					RxFrameReady = true;
+					Servo_TCNT2 = TCNT2;			// Reset signal loss timer and Overdue state
+					RC_Timeout = 0;
+					Overdue = false;
+				}
+			}
 		}
+		
+		changed >>= 1;
+		pins >>= 1;
 	}
 }
 
+// PD0, PD2, PD3 (Throttle, Elevator, Aileron)
 ISR(PCINT3_vect)
 {
-	if (JitterGate)	JitterFlag = true;	
-		
-	if (RX_COLL)	// Rising
-	{
-		RxChannelStart[THROTTLE] = TCNT1;
-	} 
-	else 
-	{				// Falling
-		RxChannel[THROTTLE] = TCNT1 - RxChannelStart[THROTTLE];
-		if (Config.PWM_Sync == THROTTLE) 
-		{
-			Interrupted = true;						// Signal that interrupt block has finished
-			Servo_TCNT2 = TCNT2;					// Reset signal loss timer and Overdue state 
-			RC_Timeout = 0;
-			Overdue = false;
-		}
-	}
-}
+	// Latch the timer before anything else
+	uint16_t tCount = TCNT1;
+	uint8_t pins = PIND;
+	uint8_t changed;
+
+	// Log interrupts that occur during PWM generation
+	if (JitterGate)	JitterFlag = true;
+
+	changed = (pins ^ PWM_PortD_Old) & PWM_PORTD_MASK;
+	PWM_PortD_Old = pins;
 
+	PWM_Edges(changed, pins, PWM_PortD_Chan, tCount);
+}
 
+// PB0, PB2 (Gear, Rudder)
 ISR(PCINT1_vect)
 {
+	uint16_t tCount = TCNT1;
+	uint8_t pins = PINB;
+	uint8_t changed;
+
 	if (JitterGate)	JitterFlag = true;
 
-	if (RX_AUX)	// Rising
-	{
-		RxChannelStart[GEAR] = TCNT1;
-	} 
-	else 
-	{				// Falling
-		RxChannel[GEAR] = TCNT1 - RxChannelStart[GEAR];
-		if (Config.PWM_Sync == GEAR) 
-		{
-			Interrupted = true;						// Signal that interrupt block has finished
-			Servo_TCNT2 = TCNT2;					// Reset signal loss timer and Overdue state 
-			RC_Timeout = 0;
-			Overdue = false;
-		}
-	}
+	changed = (pins ^ PWM_PortB_Old) & PWM_PORTB_MASK;
+	PWM_PortB_Old = pins;
+
+	PWM_Edges(changed, pins, PWM_PortB_Chan, tCount);
 }
 
 //************************************************************
-// INT2 is shared between RUDDER in PWM mode or CPPM in CPPM mode
+// INT2 is only used for CPPM. In PWM mode RUDDER shares the pin
+// but is handled by the PCINT1 vector above.
 // NB: Raw CPPM channel order (0,1,2,3,4,5,6,7) is 
-// mapped via Config.ChannelOrder[]. Actual channel values are always
+// mapped via Config.Derived.ChannelOrder[]. Actual channel values are always
 // in the sequence THROTTLE, AILERON, ELEVATOR, RUDDER, GEAR, AUX1, AUX2, AUX3
 //
 // Compacted CPPM RX code thanks to Edgar
@@ -182,25 +207,6 @@ ISR(INT2_vect)
 	uint8_t curChannel;
 	uint8_t prevChannel;
 
-	if (Config.RxMode != CPPM_MODE)
-	{
-		if (RX_YAW)	// Rising
-		{
-			RxChannelStart[RUDDER] = tCount;
-		} 
-		else 
-		{			// Falling
-			RxChannel[RUDDER] = tCount - RxChannelStart[RUDDER];
-			if (Config.PWM_Sync == RUDDER) 
-			{
-				Interrupted = true;					// Signal that interrupt block has finished
-				Servo_TCNT2 = TCNT2;				// Reset signal loss timer and Overdue state 
-				RC_Timeout = 0;
-				Overdue = false;
-			}
-		}
-	}
-	
 	//************************************************************
 	// CPPM code:
 	// This code keeps track of the number of channels received
@@ -210,7 +216,7 @@ ISR(INT2_vect)
 	// minimum inter-channel pulse is 300us. This suits "27ms" FrSky
 	// CPPM receivers.
 	//************************************************************
-	else
+	if (Config.RxMode == CPPM_MODE)
 	{
 		// Only respond to negative-going interrupts
 		if (CPPM) return;
@@ -226,12 +232,12 @@ ISR(INT2_vect)
 		PPMSyncStart = tCount;
 
 		// Get the channel number of the current channel in the requested channel order
-        curChannel = Config.ChannelOrder[ch_num];
+        curChannel = Config.Derived.ChannelOrder[ch_num];
 
 		// Set up previous channel number based on the requested channel order
 		if (ch_num > 0)
 		{
-			prevChannel = Config.ChannelOrder[ch_num-1];
+			prevChannel = Config.Derived.ChannelOrder[ch_num-1];
 		}
 		else
 		{
@@ -265,6 +271,7 @@ ISR(INT2_vect)
 		else if (ch_num == max_chan)
 		{
 			Interrupted = true;					// Signal that interrupt block has finished
+			RxFrameReady = true;
 			Servo_TCNT2 = TCNT2;				// Reset signal loss timer and Overdue state 
 			RC_Timeout = 0;
 			Overdue = false;
@@ -282,21 +289,13 @@ ISR(INT2_vect)
 
 //************************************************************
 //* Serial receive interrupt
+//* Common framing code. Each byte is handed to the decoder
+//* for the current RX mode, set up by init_uart().
 //************************************************************
 
 ISR(USART0_RX_vect)
 {
 	char temp = 0;			// RX characters
-	uint16_t temp16 = 0;	// Unsigned temp reg for mask etc
-	int16_t itemp16 = 0;	// Signed temp reg 
-	uint8_t sindex = 0;		// Serial buffer index
-	uint8_t j = 0;			// GP counter and mask index
-
-	uint8_t chan_mask = 0;	// Common variables
-	uint8_t chan_shift = 0;
-	uint8_t data_mask = 0;
-	uint16_t crc = 0;
-	uint16_t checkcrc = 0;
 	
 	uint16_t Save_TCNT1;	// Timer1 (16bit) - run @ 2.5MHz (400ns) - max 26.2ms
 	uint16_t CurrentPeriod;	
@@ -316,6 +315,7 @@ ISR(USART0_RX_vect)
 	{
 		// Read byte to remove from buffer
 		temp = UDR0;
+		RxStats.uart_errors++;
 	}
 
 	// Check all for Data overrun
@@ -325,6 +325,7 @@ ISR(USART0_RX_vect)
 		temp = UDR0;
 		// Read byte to remove from buffer
 		temp = UDR0;
+		RxStats.uart_errors++;
 	}
 
 	// Valid data
@@ -368,6 +369,12 @@ ISR(USART0_RX_vect)
 
 		// Timestamp this interrupt
 		PPMSyncStart = Save_TCNT1;
+
+		// Hunt for the start of a frame if the protocol has a sync byte
+		if ((bytecount == 0) && (SerialRX.sync != 0) && ((uint8_t)temp != SerialRX.sync))
+		{
+			return;
+		}
 	
 		// Put received byte in buffer if space available
 		if (rcindex < SBUFFER_SIZE)
@@ -376,560 +383,876 @@ ISR(USART0_RX_vect)
 		}
 
 		//************************************************************
-		//* XPS Xtreme format (8-N-1/250Kbps) (1480us for a 37 bytes packet)
-		//*
-		//* Byte 0: Bit 3 should always be 0 unless there really is a lost packet.
-		//* Byte 1: RSS
-		//* Byte 2: Mask 
- 		//* 		The mask value determines the number of channels in the stream. 
-		//*			A 6 channel stream is going to have a mask of 0x003F (00000000 00111111) 
-		//*			if outputting all 6 channels.  It is possible to output only channels 2 
-		//*			and 4 in the stream (00000000 00001010).  In which case the first word 
-		//*			of data will be channel 2 and the 2nd word will be channel.
- 		//*  
-		//*  0x00   0x23   0x000A   0x5DC   0x5DD   0xF0
-		//*  ^^^^   ^^^^   ^^^^^^   ^^^^^   ^^^^^   ^^^^
-		//*  Flags  dBm     Mask    CH 2    CH 4    ChkSum
-		//*
+		//* Common exit code
 		//************************************************************
 
-		if (Config.RxMode == XTREME)
+		// Hand byte to the protocol decoder
+		if (SerialRX.decoder(temp))
+		{
+			// Frame ended. Reset variables so that back-to-back frames
+			// without an inter-packet gap are also received
+			rcindex = 0;
+			bytecount = 0;
+			ch_num = 0;
+			checksum = 0;
+			chanmask16 = 0;
+			packet_size = 0;
+		}
+		else
+		{
+			// Increment byte count
+			bytecount++;
+		}
+	
+	} // Valid data
+}
+
+//************************************************************
+//* XPS Xtreme format (8-N-1/250Kbps) (1480us for a 37 bytes packet)
+//*
+//* Byte 0: Bit 3 should always be 0 unless there really is a lost packet.
+//* Byte 1: RSS
+//* Byte 2: Mask 
+//* 		The mask value determines the number of channels in the stream. 
+//*			A 6 channel stream is going to have a mask of 0x003F (00000000 00111111) 
+//*			if outputting all 6 channels.  It is possible to output only channels 2 
+//*			and 4 in the stream (00000000 00001010).  In which case the first word 
+//*			of data will be channel 2 and the 2nd word will be channel.
+//*  
+//*  0x00   0x23   0x000A   0x5DC   0x5DD   0xF0
+//*  ^^^^   ^^^^   ^^^^^^   ^^^^^   ^^^^^   ^^^^
+//*  Flags  dBm     Mask    CH 2    CH 4    ChkSum
+//*
+//************************************************************
+
+bool Decode_Xtreme(uint8_t temp)
+{
+	uint16_t temp16 = 0;	// Unsigned temp reg for mask etc
+	uint8_t sindex = 0;		// Serial buffer index
+	uint8_t j = 0;			// GP counter and mask index
+
+	// Look at flag byte to see if the data is meant for us
+	if (bytecount == 0)
+	{
+		// Check top 3 bits for channel bank
+		// Trash checksum if not clear
+		if (temp & 0xE0)
+		{
+			checksum +=	0x55;
+		}
+	}
+
+	// Get MSB of mask byte
+	if (bytecount == 2)
+	{
+		chanmask16 = 0;
+		chanmask16 = temp << 8;		// High byte of Mask
+	}
+
+	// Combine with LSB of mask byte
+	// Work out how many channels there are supposed to be
+	if (bytecount == 3)
+	{
+		chanmask16 += (uint16_t)temp;	// Low byte of Mask
+		temp16 = chanmask16;			// Need to keep a copy od chanmask16
+
+		// Count bits set (number of active channels)				 
+		for (ch_num = 0; temp16; ch_num++)
 		{
-			// Look at flag byte to see if the data is meant for us
-			if (bytecount == 0)
+			temp16 &= temp16 - 1;
+		}
+	}
+
+	// Add up checksum up until final packet
+	if (bytecount < ((ch_num << 1) + 4))
+	{
+		checksum +=	temp;
+		
+		return false;
+	}
+
+	// Process data when all packets received
+	// Check checksum 
+	checksum &= 0xff;
+
+	// Ignore packet if checksum wrong
+	if (checksum != temp) // temp holds the transmitted checksum byte
+	{
+		Interrupted = false;
+		RxStats.bad_crc++;
+	}
+	else
+	{
+		// RC sync established
+		Interrupted = true;	
+		RxFrameReady = true;
+
+		// Reset signal loss timer and Overdue state 
+		Servo_TCNT2 = TCNT2;
+		RC_Timeout = 0;
+		Overdue = false;
+	
+		// Set start of channel data per format
+		sindex = 4; // Channel data from byte 5
+
+		// Work out which channel the data is intended for from the mask bit position
+		// Channels can be anywhere in the lower 16 channels of the Xtreme format
+		for (j = 0; j < 16; j++)
+		{
+			// If there is a bit set, allocate channel data for it
+			if (chanmask16 & (1 << j))
 			{
-				// Check top 3 bits for channel bank
-				// Trash checksum if not clear
-				if (temp & 0xE0)
+				// Reconstruct word
+				temp16 = (sBuffer[sindex] << 8) + sBuffer[sindex + 1];
+
+				// Expand to OpenAero2 units if a valid channel
+				if (j < MAX_RC_CHANNELS)
 				{
-					checksum +=	0x55;
+					RxChannel[Config.Derived.ChannelOrder[j]] = ((temp16 * 10) >> 2);
+				} 		
+
+				// Within the bounds of the buffer
+				if (sindex < SBUFFER_SIZE)
+				{
+					sindex += 2;
 				}
 			}
+		} // For each mask bit	
+	} // Checksum
+	
+	return true;
+}
+
+//************************************************************
+//* Futaba S-Bus format (8-E-2/100Kbps) (2500us for a 25 byte packet)
+//*	S-Bus decoding algorithm borrowed in part from Arduino
+//*
+//* The protocol is 25 Bytes long and is sent every 14ms (analog mode) or 7ms (high speed mode).
+//* One Byte = 1 start bit + 8 data bit + 1 parity bit + 2 stop bit (8E2), baud rate = 100,000 bit/s
+//*
+//* The highest bit is sent first. The logic is inverted :( Stupid Futaba.
+//*
+//* [start byte] [data1] [data2] .... [data22] [flags][end byte]
+//* 
+//* 0 start byte = 11110000b (0xF0)
+//* 1-22 data = [ch1, 11bit][ch2, 11bit] .... [ch16, 11bit] (Values = 0 to 2047)
+//* 	channel 1 uses 8 bits from data1 and 3 bits from data2
+//* 	channel 2 uses last 5 bits from data2 and 6 bits from data3
+//* 	etc.
+//* 
+//* 23 flags = 
+//*		bit7 = ch17 = digital channel (0x80)
+//* 	bit6 = ch18 = digital channel (0x40)
+//* 	bit5 = Frame lost, equivalent red LED on receiver (0x20)
+//* 	bit4 = failsafe activated (0x10)
+//* 	bit3 = n/a
+//* 	bit2 = n/a
+//* 	bit1 = n/a
+//* 	bit0 = n/a
+//* 24 endbyte = 00000000b (SBUS) or (variable) (SBUS2)
+//*
+//* Data size:	0 to 2047, centered on 1024 (1.520ms)
+//* 
+//* 0 		= 880us
+//* 224		= 1020us
+//* 1024 	= 1520us +/-800 for 1-2ms (OAV = +/-1250)
+//* 1824	= 2020us
+//* 2047 	= 2160us
+//*
+//************************************************************
+
+bool Decode_SBus(uint8_t temp)
+{
+	int16_t itemp16 = 0;	// Signed temp reg 
+	uint8_t sindex = 0;		// Serial buffer index
+	uint8_t j = 0;			// GP counter and mask index
+
+	uint8_t chan_mask = 0;	// Common variables
+	uint8_t chan_shift = 0;
+	uint8_t data_mask = 0;
+
+	// Flag that packet has completed
+	// End bytes can be 00, 04, 14, 24, 34 and possibly 08 for FASSTest 12-channel
+	//if ((bytecount == 24) && ((temp == 0x00) || (temp == 0x04) || (temp == 0x14) || (temp == 0x24) || (temp == 0x34) || (temp == 0x08)))
+	if (bytecount != 24)
+	{
+		return false;
+	}
+
+	// RC sync established
+	Interrupted = true;
+	RxFrameReady = true;
+	Servo_TCNT2 = TCNT2;
+	RC_Timeout = 0;
+	Overdue = false;
+	
+	// Count frames flagged as lost by the receiver
+	if (sBuffer[23] & 0x20)
+	{
+		RxStats.frame_lost++;
+	}
+
+	// Clear channel data
+	for (j = 0; j < MAX_RC_CHANNELS; j++)
+	{
+		RxChannel[j] = 0;
+	}
+
+	// Start from second byte
+	sindex = 1;
+
+	// Deconstruct S-Bus data
+	// 8 channels * 11 bits = 88 bits
+	for (j = 0; j < 88; j++)
+	{
+		if (sBuffer[sindex] & (1 << chan_mask))
+		{
+			// Place the RC data into the correct channel order for the transmitted system
+			RxChannel[Config.Derived.ChannelOrder[chan_shift]] |= (1 << data_mask);
+		}
+
+		chan_mask++;
+		data_mask++;
+
+		// If we have done 8 bits, move to next byte in buffer
+		if (chan_mask == 8)
+		{
+			chan_mask = 0;
+			sindex++;
+		}
 
-			// Get MSB of mask byte
-			if (bytecount == 2)
+		// If we have reconstructed all 11 bits of one channel's data (2047)
+		// increment the channel number
+		if (data_mask == 11)
+		{
+			data_mask =0;
+			chan_shift++;
+		}
+	}
+
+	// Convert to  OpenAero2 values
+	for (j = 0; j < MAX_RC_CHANNELS; j++)
+	{
+		// Subtract Futaba offset
+		itemp16 = RxChannel[j] - 1024;
+			
+		// Expand into OpenAero2 units x1.562 (1.562) (1250/800)
+		itemp16 = itemp16 + (itemp16 >> 1) + (itemp16 >> 4);
+
+		// Add back in OpenAero2 offset
+		RxChannel[j] = itemp16 + 3750;		
+	} 	
+
+	return true;
+}
+
+//************************************************************
+//* Spektrum Satellite format (8-N-1/115Kbps) MSB sent first (1391us for a 16 byte packet)
+//* DX7/DX6i: One data-frame at 115200 baud every 22ms.
+//* DX7se:    One data-frame at 115200 baud every 11ms.
+//*
+//*    byte1: is a frame loss counter
+//*    byte2: [0 0 0 R 0 0 N1 N0]
+//*    byte3:  and byte4:  channel data (FLT-Mode)	= FLAP 6
+//*    byte5:  and byte6:  channel data (Roll)		= AILE A
+//*    byte7:  and byte8:  channel data (Pitch)		= ELEV E
+//*    byte9:  and byte10: channel data (Yaw)		= RUDD R
+//*    byte11: and byte12: channel data (Gear Switch) GEAR 5
+//*    byte13: and byte14: channel data (Throttle)	= THRO T
+//*    byte15: and byte16: channel data (AUX2)		= AUX2 8
+//* 
+//* DS9 (9 Channel): One data-frame at 115200 baud every 11ms,
+//* alternating frame 1/2 for CH1-7 / CH8-9
+//*
+//*   1st Frame:
+//*    byte1: is a frame loss counter
+//*    byte2: [0 0 0 R 0 0 N1 N0]
+//*    byte3:  and byte4:  channel data
+//*    byte5:  and byte6:  channel data
+//*    byte7:  and byte8:  channel data
+//*    byte9:  and byte10: channel data
+//*    byte11: and byte12: channel data
+//*    byte13: and byte14: channel data
+//*    byte15: and byte16: channel data
+//*   2nd Frame:
+//*    byte1: is a frame loss counter
+//*    byte2: [0 0 0 R 0 0 N1 N0]
+//*    byte3:  and byte4:  channel data
+//*    byte5:  and byte6:  channel data
+//*    byte7:  and byte8:  0xffff
+//*    byte9:  and byte10: 0xffff
+//*    byte11: and byte12: 0xffff
+//*    byte13: and byte14: 0xffff
+//*    byte15: and byte16: 0xffff
+//* 
+//* Each channel data (16 bit= 2byte, first msb, second lsb) is arranged as:
+//* 
+//* Bits: F 00 C3 C2 C1 C0  D9 D8 D7 D6 D5 D4 D3 D2 D1 D0 for 10-bit data (0 to 1023) or
+//* Bits: F C3 C2 C1 C0 D10 D9 D8 D7 D6 D5 D4 D3 D2 D1 D0 for 11-bit data (0 to 2047) 
+//* 
+//* R: 0 for 10 bit resolution 1 for 11 bit resolution channel data
+//* N1 to N0 is the number of frames required to receive all channel data. 
+//* F: 1 = indicates beginning of 2nd frame for CH8-9 (DS9 only)
+//* C3 to C0 is the channel number. 0 to 9 (4 bit, as assigned in the transmitter)
+//* D9 to D0 is the channel data 
+//*		(10 bit) 0xaa..0x200..0x356 for 100% transmitter-travel
+//*		(11 bit) 0x154..0x400..0x6ac for 100% transmitter-travel
+//*
+//* The data values can range from 0 to 1023/2047 to define a servo pulse width 
+//* 
+//* 0 		= 920us
+//* 157		= 1010us
+//* 1024 	= 1510us +/- 867.5 for 1-2ms or 0.576ns/bit
+//* 1892	= 2010us
+//* 2047 	= 2100us
+//*
+//* Byte 2 is not a reliable guide to the resolution as satellites 
+//* send a fade count there. Instead, the channel numbers of the first 
+//* few frames are decoded both ways. Only the correct resolution 
+//* gives a contiguous set of channels from zero.
+//* The frame period (11 or 22ms) is measured between frames.
+//* Each frame flags the channels it carried in RxChannelFresh, so that
+//* split 11ms frames are used as they arrive.
+//*
+//************************************************************
+
+// Returns true if the mask is a plausible set of channels 0 to n
+static inline bool Spektrum_Contiguous(uint16_t mask)
+{
+	return ((mask >= ((1 << SPEKTRUM_MIN_CHANNELS) - 1)) && ((mask & (mask + 1)) == 0));
+}
+
+bool Decode_Spektrum(uint8_t temp)
+{
+	uint16_t temp16 = 0;	// Unsigned temp reg for mask etc
+	int16_t itemp16 = 0;	// Signed temp reg 
+	uint8_t sindex = 0;		// Serial buffer index
+	uint8_t j = 0;			// GP counter and mask index
+
+	uint8_t chan_mask = 0;	// Common variables
+	uint8_t chan_shift = 0;
+	uint8_t data_mask = 0;
+	bool ok10, ok11;
+
+	// Process data when all packets received
+	if (bytecount != 15)
+	{
+		return false;
+	}
+
+	// Just stick the last byte into the buffer manually...(hides)
+	sBuffer[15] = temp;
+
+	// Set start of channel data per format
+	sindex = 2; // Channel data from byte 3
+
+	// Measure the frame period. Ignore gaps caused by lost frames.
+	temp16 = PPMSyncStart - SpektrumLastFrame;
+	SpektrumLastFrame = PPMSyncStart;
+
+	if ((temp16 > SPEKTRUM_11MS_MIN) && (temp16 < SPEKTRUM_11MS_MAX))
+	{
+		SpektrumFormat |= (SPEKTRUM_RATE_KNOWN | SPEKTRUM_11MS);
+	}
+	else if ((temp16 > SPEKTRUM_22MS_MIN) && (temp16 < SPEKTRUM_22MS_MAX))
+	{
+		SpektrumFormat = (SpektrumFormat & ~SPEKTRUM_11MS) | SPEKTRUM_RATE_KNOWN;
+	}
+
+	// Work out if this is 10 or 11 bit data from the channel numbers
+	if (!(SpektrumFormat & SPEKTRUM_RES_KNOWN))
+	{
+		for (j = 0; j < 7; j++)
+		{
+			temp16 = (sBuffer[sindex] << 8) + sBuffer[sindex + 1];
+			
+			// Skip blank channels
+			if (temp16 != 0xFFFF)
 			{
-				chanmask16 = 0;
-				chanmask16 = temp << 8;		// High byte of Mask
+				SpektrumMask10 |= (1 << ((temp16 >> 10) & 0x0F));
+				SpektrumMask11 |= (1 << ((temp16 >> 11) & 0x0F));
 			}
+			
+			sindex += 2;
+		}
 
-			// Combine with LSB of mask byte
-			// Work out how many channels there are supposed to be
-			if (bytecount == 3)
+		if (++SpektrumGuess >= SPEKTRUM_GUESS_FRAMES)
+		{
+			ok10 = Spektrum_Contiguous(SpektrumMask10);
+			ok11 = Spektrum_Contiguous(SpektrumMask11);
+			
+			if (ok11 && !ok10)
 			{
-				chanmask16 += (uint16_t)temp;	// Low byte of Mask
-				temp16 = chanmask16;			// Need to keep a copy od chanmask16
-
-				// Count bits set (number of active channels)				 
-				for (ch_num = 0; temp16; ch_num++)
-				{
-					temp16 &= temp16 - 1;
-				}
+				SpektrumFormat |= (SPEKTRUM_RES_KNOWN | SPEKTRUM_2048);
+			}
+			else if (ok10 && !ok11)
+			{
+				SpektrumFormat |= SPEKTRUM_RES_KNOWN;
 			}
+			
+			// Start again if still undecided
+			SpektrumMask10 = 0;
+			SpektrumMask11 = 0;
+			SpektrumGuess = 0;
+		}
+		
+		// No channel data until the resolution is known
+		return true;
+	}
 
-			// Add up checksum up until final packet
-			if (bytecount < ((ch_num << 1) + 4))
+	if (SpektrumFormat & SPEKTRUM_2048)
+	{
+		chan_mask = 0x78;	// 11 bit (2048)
+		data_mask = 0x07;
+		chan_shift = 0x03;
+	}
+	else
+	{
+		chan_mask = 0x3C;	// 10 bit (1024)
+		data_mask = 0x03;
+		chan_shift = 0x02;
+	}
+
+	// Work out which channel the data is intended for from the channel number data
+	// Channels can also be in the second packet. Spektrum has 7 channels per packet.
+	for (j = 0; j < 7; j++)
+	{
+		// Extract channel number
+		ch_num = (sBuffer[sindex] & chan_mask) >> chan_shift;
+
+		// Reconstruct channel data
+		temp16 = ((sBuffer[sindex] & data_mask) << 8) + sBuffer[sindex + 1];
+
+		// Expand to OpenAero2 units if a valid channel
+		// Blank channels have the channel number of 16
+		if (ch_num < MAX_RC_CHANNELS)
+		{
+			// Subtract Spektrum center offset
+			if (chan_shift == 0x03) // 11-bit
 			{
-				checksum +=	temp;
+				itemp16 = temp16 - 1024;
 			}
-	
-			// Process data when all packets received
 			else
 			{
-				// Check checksum 
-				checksum &= 0xff;
+				itemp16 = temp16 - 512;	
+			}					
 
-				// Ignore packet if checksum wrong
-				if (checksum != temp) // temp holds the transmitted checksum byte
-				{
-					Interrupted = false;
-					ch_num = 0;
-					checksum = 0;
-				}
-				else
-				{
-					// RC sync established
-					Interrupted = true;	
+			// Spektrum to System
+			// Expand into OpenAero2 units (1250/867.5) x2 = 2.8818 (2.875) 2+.5+.25-1/8
+			itemp16 = (itemp16 << 1) + (itemp16 >> 1) + (itemp16 >> 2) + (itemp16 >> 3);
 
-					// Reset signal loss timer and Overdue state 
-					Servo_TCNT2 = TCNT2;
-					RC_Timeout = 0;
-					Overdue = false;
-			
-					// Set start of channel data per format
-					sindex = 4; // Channel data from byte 5
-
-					// Work out which channel the data is intended for from the mask bit position
-					// Channels can be anywhere in the lower 16 channels of the Xtreme format
-					for (j = 0; j < 16; j++)
-					{
-						// If there is a bit set, allocate channel data for it
-						if (chanmask16 & (1 << j))
-						{
-							// Reconstruct word
-							temp16 = (sBuffer[sindex] << 8) + sBuffer[sindex + 1];
-
-							// Expand to OpenAero2 units if a valid channel
-							if (j < MAX_RC_CHANNELS)
-							{
-								RxChannel[Config.ChannelOrder[j]] = ((temp16 * 10) >> 2);
-							} 		
-
-							// Within the bounds of the buffer
-							if (sindex < SBUFFER_SIZE)
-							{
-								sindex += 2;
-							}
-						}
-					} // For each mask bit	
-				} // Checksum
-			} // Check end of data
-		} // (Config.RxMode == XTREME)
+			if (chan_shift == 0x03) // 11-bit
+			{
+				// Divide in case of 11-bit value
+				itemp16 = itemp16 >> 1;								
+			}
 
-		//************************************************************
-		//* Futaba S-Bus format (8-E-2/100Kbps) (2500us for a 25 byte packet)
-		//*	S-Bus decoding algorithm borrowed in part from Arduino
-		//*
-		//* The protocol is 25 Bytes long and is sent every 14ms (analog mode) or 7ms (high speed mode).
-		//* One Byte = 1 start bit + 8 data bit + 1 parity bit + 2 stop bit (8E2), baud rate = 100,000 bit/s
-		//*
-		//* The highest bit is sent first. The logic is inverted :( Stupid Futaba.
-		//*
-		//* [start byte] [data1] [data2] .... [data22] [flags][end byte]
-		//* 
-		//* 0 start byte = 11110000b (0xF0)
-		//* 1-22 data = [ch1, 11bit][ch2, 11bit] .... [ch16, 11bit] (Values = 0 to 2047)
-		//* 	channel 1 uses 8 bits from data1 and 3 bits from data2
-		//* 	channel 2 uses last 5 bits from data2 and 6 bits from data3
-		//* 	etc.
-		//* 
-		//* 23 flags = 
-		//*		bit7 = ch17 = digital channel (0x80)
-		//* 	bit6 = ch18 = digital channel (0x40)
-		//* 	bit5 = Frame lost, equivalent red LED on receiver (0x20)
-		//* 	bit4 = failsafe activated (0x10)
-		//* 	bit3 = n/a
-		//* 	bit2 = n/a
-		//* 	bit1 = n/a
-		//* 	bit0 = n/a
-		//* 24 endbyte = 00000000b (SBUS) or (variable) (SBUS2)
-		//*
-		//* Data size:	0 to 2047, centered on 1024 (1.520ms)
-		//* 
-		//* 0 		= 880us
-		//* 224		= 1020us
-		//* 1024 	= 1520us +/-800 for 1-2ms (OAV = +/-1250)
-		//* 1824	= 2020us
-		//* 2047 	= 2160us
-		//*
-		//************************************************************
+			// Add back in OpenAero2 offset
+			itemp16 += 3750;										
 
-		if (Config.RxMode == SBUS)
-		{
-			// Flag that packet has completed
-			// End bytes can be 00, 04, 14, 24, 34 and possibly 08 for FASSTest 12-channel
-			//if ((bytecount == 24) && ((temp == 0x00) || (temp == 0x04) || (temp == 0x14) || (temp == 0x24) || (temp == 0x34) || (temp == 0x08)))
-			if (bytecount == 24)
-			{
-				// RC sync established
-				Interrupted = true;
-				Servo_TCNT2 = TCNT2;
-				RC_Timeout = 0;
-				Overdue = false;
-				
-				// Clear channel data
-				for (j = 0; j < MAX_RC_CHANNELS; j++)
-				{
-					RxChannel[j] = 0;
-				}
+			RxChannel[Config.Derived.ChannelOrder[ch_num]] = itemp16;
+			RxChannelFresh |= (1 << Config.Derived.ChannelOrder[ch_num]);
+		}
 
-				// Start from second byte
-				sindex = 1;
+		sindex += 2;
 
-				// Deconstruct S-Bus data
-				// 8 channels * 11 bits = 88 bits
-				for (j = 0; j < 88; j++)
-				{
-					if (sBuffer[sindex] & (1 << chan_mask))
-					{
-						// Place the RC data into the correct channel order for the transmitted system
-						RxChannel[Config.ChannelOrder[chan_shift]] |= (1 << data_mask);
-					}
-
-					chan_mask++;
-					data_mask++;
-
-					// If we have done 8 bits, move to next byte in buffer
-					if (chan_mask == 8)
-					{
-						chan_mask = 0;
-						sindex++;
-					}
-
-					// If we have reconstructed all 11 bits of one channel's data (2047)
-					// increment the channel number
-					if (data_mask == 11)
-					{
-						data_mask =0;
-						chan_shift++;
-					}
-				}
+	} // For each pair of bytes
 
-				// Convert to  OpenAero2 values
-				for (j = 0; j < MAX_RC_CHANNELS; j++)
-				{
-					// Subtract Futaba offset
-					itemp16 = RxChannel[j] - 1024;
-						
-					// Expand into OpenAero2 units x1.562 (1.562) (1250/800)
-					itemp16 = itemp16 + (itemp16 >> 1) + (itemp16 >> 4);
-
-					// Add back in OpenAero2 offset
-					RxChannel[j] = itemp16 + 3750;		
-				} 	
-			
-			} // Packet ended flag
+	// RC sync established
+	Interrupted = true;
+	RxFrameReady = true;
 	
-		} // (Config.RxMode == SBUS)
+	// Reset signal loss timer and Overdue state 
+	Servo_TCNT2 = TCNT2;
+	RC_Timeout = 0;
+	Overdue = false;
 
-		//************************************************************
-		//* Spektrum Satellite format (8-N-1/115Kbps) MSB sent first (1391us for a 16 byte packet)
-		//* DX7/DX6i: One data-frame at 115200 baud every 22ms.
-		//* DX7se:    One data-frame at 115200 baud every 11ms.
-		//*
-		//*    byte1: is a frame loss counter
-		//*    byte2: [0 0 0 R 0 0 N1 N0]
-		//*    byte3:  and byte4:  channel data (FLT-Mode)	= FLAP 6
-		//*    byte5:  and byte6:  channel data (Roll)		= AILE A
-		//*    byte7:  and byte8:  channel data (Pitch)		= ELEV E
-		//*    byte9:  and byte10: channel data (Yaw)		= RUDD R
-		//*    byte11: and byte12: channel data (Gear Switch) GEAR 5
-		//*    byte13: and byte14: channel data (Throttle)	= THRO T
-		//*    byte15: and byte16: channel data (AUX2)		= AUX2 8
-		//* 
-		//* DS9 (9 Channel): One data-frame at 115200 baud every 11ms,
-		//* alternating frame 1/2 for CH1-7 / CH8-9
-		//*
-		//*   1st Frame:
-		//*    byte1: is a frame loss counter
-		//*    byte2: [0 0 0 R 0 0 N1 N0]
-		//*    byte3:  and byte4:  channel data
-		//*    byte5:  and byte6:  channel data
-		//*    byte7:  and byte8:  channel data
-		//*    byte9:  and byte10: channel data
-		//*    byte11: and byte12: channel data
-		//*    byte13: and byte14: channel data
-		//*    byte15: and byte16: channel data
-		//*   2nd Frame:
-		//*    byte1: is a frame loss counter
-		//*    byte2: [0 0 0 R 0 0 N1 N0]
-		//*    byte3:  and byte4:  channel data
-		//*    byte5:  and byte6:  channel data
-		//*    byte7:  and byte8:  0xffff
-		//*    byte9:  and byte10: 0xffff
-		//*    byte11: and byte12: 0xffff
-		//*    byte13: and byte14: 0xffff
-		//*    byte15: and byte16: 0xffff
-		//* 
-		//* Each channel data (16 bit= 2byte, first msb, second lsb) is arranged as:
-		//* 
-		//* Bits: F 00 C3 C2 C1 C0  D9 D8 D7 D6 D5 D4 D3 D2 D1 D0 for 10-bit data (0 to 1023) or
-		//* Bits: F C3 C2 C1 C0 D10 D9 D8 D7 D6 D5 D4 D3 D2 D1 D0 for 11-bit data (0 to 2047) 
-		//* 
-		//* R: 0 for 10 bit resolution 1 for 11 bit resolution channel data
-		//* N1 to N0 is the number of frames required to receive all channel data. 
-		//* F: 1 = indicates beginning of 2nd frame for CH8-9 (DS9 only)
-		//* C3 to C0 is the channel number. 0 to 9 (4 bit, as assigned in the transmitter)
-		//* D9 to D0 is the channel data 
-		//*		(10 bit) 0xaa..0x200..0x356 for 100% transmitter-travel
-		//*		(11 bit) 0x154..0x400..0x6ac for 100% transmitter-travel
-		//*
-		//* The data values can range from 0 to 1023/2047 to define a servo pulse width 
-		//* 
-		//* 0 		= 920us
-		//* 157		= 1010us
-		//* 1024 	= 1510us +/- 867.5 for 1-2ms or 0.576ns/bit
-		//* 1892	= 2010us
-		//* 2047 	= 2100us
-		//*
-		//************************************************************
+	return true;
+}
+
+//************************************************************
+//* XBUS Mode B/UDI RX Data format 115200Kbit/s, 8 data bit, no parity, and one stop bit. 
+//* Portions of code adopted from MultiWii and from GruffyPuffy/cleanflight.
+//* 
+//* First byte = vendor ID		0xA1 = 12-Ch Data
+//*								0xA2 = 16-Ch Data
+//*
+//* Next 24/32 bytes = 12/16 channels of 16-bit servo data, high-byte first
+//* Last 2 bytes = CRC value over first 25/33 bytes, using CRC-CCITT algorithm.
+//*
+//* Pulse length conversion from [0...4095] to s:
+//*      800s  -> 0x000
+//*      1500s -> 0x800 (2048)
+//*      2200s -> 0xFFF
+//*
+//* Total range is: 2200 - 800 = 1400 <==> 4096
+//* Use formula: 800 + value * 1400 / 4096 (i.e. a shift by 12)
+//*
+//* The data values can range from 0 to 4095 to define a servo pulse width.
+//* Each bit in servo data corresponds to pulse width change of 0.342s. 
+//* 
+//* 0 		= 800us
+//* 585		= 1000us
+//* 2048 	= 1500us +/- 1463 for 1-2ms
+//* 3511	= 2000us
+//* 4095 	= 2200us		 
+//*
+//************************************************************
 
-		// Handle Spektrum format
-		if (Config.RxMode == SPEKTRUM)
+bool Decode_ModeB(uint8_t temp)
+{
+	int16_t itemp16 = 0;	// Signed temp reg 
+	uint8_t j = 0;			// GP counter and mask index
+	uint16_t crc = 0;
+	uint16_t checkcrc = 0;
+
+	// Work out the expected number of bytes based on the vendor ID (1st byte)
+	if (bytecount == 0)
+	{
+		// Process data when all packets received
+		if (temp == MODEB_SYNCBYTE)				// 12-channel packet
 		{
-			// Process data when all packets received
-			if (bytecount == 15)
-			{
-				// Just stick the last byte into the buffer manually...(hides)
-				sBuffer[15] = temp;
+			packet_size = XBUS_FRAME_SIZE_12;
+		}
+		else									// Probably a 16-channel packet
+		{
+			packet_size = XBUS_FRAME_SIZE_16;
+		}
+	}
 
-				// Set start of channel data per format
-				sindex = 2; // Channel data from byte 3
+	// Check checksum when all data received
+	if (bytecount != (packet_size - 1))
+	{
+		return false;
+	}
 
-				// Work out if this is 10 or 11 bit data
-				if ((sBuffer[1] & 0xF0) != 0) 	// 0 for 10 bit resolution, otherwise 11 bit resolution
-				{
-					chan_mask = 0x78;	// 11 bit (2048)
-					data_mask = 0x07;
-					chan_shift = 0x03;
-				}
-				else
-				{
-					chan_mask = 0x3C;	// 10 bit (1024)
-					data_mask = 0x03;
-					chan_shift = 0x02;
-				}
+	// Add up checksum for all bytes up to but not including the checksum
+	for (j = 0; j < (packet_size - 2); j++)
+	{
+		crc = CRC16(crc, sBuffer[j]);
+	}
 
-				// Work out which channel the data is intended for from the channel number data
-				// Channels can also be in the second packet. Spektrum has 7 channels per packet.
-				for (j = 0; j < 7; j++)
-				{
-					// Extract channel number
-					ch_num = (sBuffer[sindex] & chan_mask) >> chan_shift;
-
-					// Reconstruct channel data
-					temp16 = ((sBuffer[sindex] & data_mask) << 8) + sBuffer[sindex + 1];
-
-					// Expand to OpenAero2 units if a valid channel
-					// Blank channels have the channel number of 16
-					if (ch_num < MAX_RC_CHANNELS)
-					{
-						// Subtract Spektrum center offset
-						if (chan_shift == 0x03) // 11-bit
-						{
-							itemp16 = temp16 - 1024;
-						}
-						else
-						{
-							itemp16 = temp16 - 512;	
-						}					
-
-						// Spektrum to System
-						// Expand into OpenAero2 units (1250/867.5) x2 = 2.8818 (2.875) 2+.5+.25-1/8
-						itemp16 = (itemp16 << 1) + (itemp16 >> 1) + (itemp16 >> 2) + (itemp16 >> 3);
-
-						if (chan_shift == 0x03) // 11-bit
-						{
-							// Divide in case of 11-bit value
-							itemp16 = itemp16 >> 1;								
-						}
-
-						// Add back in OpenAero2 offset
-						itemp16 += 3750;										
-
-						RxChannel[Config.ChannelOrder[ch_num]] = itemp16;
-					}
+	// Extract the packet's own checksum
+	checkcrc = ((uint16_t)(sBuffer[packet_size - 2] << 8) | (uint16_t)(sBuffer[packet_size - 1]));
+	
+	// Compare with the calculated one and process data if ok
+	if (checkcrc == crc)
+	{
+		// RC sync established
+		Interrupted = true;
+		RxFrameReady = true;
+		
+		// Reset signal loss timer and Overdue state 					
+		Servo_TCNT2 = TCNT2;
+		RC_Timeout = 0;
+		Overdue = false;
 
-					sindex += 2;
+		// Copy unconverted channel data
+		for (j = 0; j < MAX_RC_CHANNELS; j++)
+		{
+			// Combine bytes from buffer
+			TempRxChannel[j] = (uint16_t)(sBuffer[(j << 1) + 1] << 8) | (sBuffer[(j << 1) + 2]);
+		}
 
-				} // For each pair of bytes
-			
-				// RC sync established
-				Interrupted = true;
-				
-				// Reset signal loss timer and Overdue state 
-				Servo_TCNT2 = TCNT2;
-				RC_Timeout = 0;
-				Overdue = false;
+		// Convert to system values
+		for (j = 0; j < MAX_RC_CHANNELS; j++)
+		{
+			// Subtract MODEB offset
+			itemp16 = TempRxChannel[j] - 2048;
 			
-			} // Check end of data
+			// Expand into OpenAero2 units x0.8544 (0.8555)	(1250/1463)
+			itemp16 = (itemp16 >> 1) + (itemp16 >> 2) + (itemp16 >> 4) + (itemp16 >> 5) + (itemp16 >> 7) + (itemp16 >> 8);
+
+			// Add back in OpenAero2 offset
+			RxChannel[Config.Derived.ChannelOrder[j]] = itemp16 + 3750;
+		}
+	}
+	else
+	{
+		RxStats.bad_crc++;
+	}
+
+	return true;
+}
+
+//************************************************************
+//* HoTT SUMD RX Data format 115200Kbit/s, 8 data bit, no parity, and one stop bit. 
+//* 
+//* First byte = vendor ID		0xA8 
+//* Second byte = status		0x01	Valid byte
+//*								0x81	Valid byte with failsafe bit set
+//* Third byte			0x02 to 0x20	Number of channels (2 to 32)
+//*
+//* Next 2 to 32 bytes = n channels of 16-bit servo data, high-byte first
+//* Last 2 bytes = CRC value over first n*2 + 3 bytes (data + header), using CRC-CCITT algorithm.
+//*
+//* Pulse length conversion from [0...4095] to s:
+//*      900s  -> 0x1c20 (7200)
+//*      1500s -> 0x2ee0 (12000)
+//*      2100s -> 0x41a0 (16800)
+//*
+//* Total range is: 16800 - 7200 = 9600 or +/-4800 bits and +/- 600us
+//*
+//* The data values can range from 7200 to 16800 to define a servo pulse width.
+//* Each bit in servo data corresponds to pulse width change of 125ns or 0.125us. 
+//* 
+//* 8000	= 1000us
+//* 12000 	= 1500us +/- 4000 for 1-2ms
+//* 16000	= 2000us
+//*
+//************************************************************
+
+bool Decode_SUMD(uint8_t temp)
+{
+	int16_t itemp16 = 0;	// Signed temp reg 
+	uint8_t j = 0;			// GP counter and mask index
+	uint16_t crc = 0;
+	uint16_t checkcrc = 0;
+
+	// Work out the expected number of bytes based on the channel info (3rd byte)
+	if (bytecount == 2)
+	{
+		// Look at the number of channels x 2 + 2(CRC) + 3(Header)
+		packet_size = (temp << 1) + 5;
 		
-		} // (Config.RxMode == SPEKTRUM)
+		// Sanity check for packet size
+		if (packet_size > MAXSUMDPACKET)
+		{
+			packet_size = MAXSUMDPACKET;
+		}
+	}
 
-		//************************************************************
-		//* XBUS Mode B/UDI RX Data format 115200Kbit/s, 8 data bit, no parity, and one stop bit. 
-		//* Portions of code adopted from MultiWii and from GruffyPuffy/cleanflight.
-		//* 
-		//* First byte = vendor ID		0xA1 = 12-Ch Data
-		//*								0xA2 = 16-Ch Data
-		//*
-		//* Next 24/32 bytes = 12/16 channels of 16-bit servo data, high-byte first
-		//* Last 2 bytes = CRC value over first 25/33 bytes, using CRC-CCITT algorithm.
-		//*
-		//* Pulse length conversion from [0...4095] to s:
-		//*      800s  -> 0x000
-		//*      1500s -> 0x800 (2048)
-		//*      2200s -> 0xFFF
-		//*
-		//* Total range is: 2200 - 800 = 1400 <==> 4096
-		//* Use formula: 800 + value * 1400 / 4096 (i.e. a shift by 12)
-		//*
-		//* The data values can range from 0 to 4095 to define a servo pulse width.
-		//* Each bit in servo data corresponds to pulse width change of 0.342s. 
-		//* 
-		//* 0 		= 800us
-		//* 585		= 1000us
-		//* 2048 	= 1500us +/- 1463 for 1-2ms
-		//* 3511	= 2000us
-		//* 4095 	= 2200us		 
-		//*
-		//************************************************************
+	// Check checksum when all data received and packet size determined
+	if ((packet_size == 0) || (bytecount != (packet_size - 1)))
+	{
+		return false;
+	}
+
+	// Add up checksum for all bytes up to but not including the checksum
+	for (j = 0; j < (packet_size - 2); j++)
+	{
+		crc = CRC16(crc, sBuffer[j]);
+	}
+
+	// Extract the packet's own checksum
+	checkcrc = ((uint16_t)(sBuffer[packet_size - 2] << 8) | (uint16_t)(sBuffer[packet_size - 1]));
+	
+	// Compare with the calculated one and process data if ok
+	if (checkcrc == crc)
+	{
+		// RC sync established
+		Interrupted = true;
+		RxFrameReady = true;
 		
-		// Handle SXRL format
-		if (Config.RxMode == MODEB)
+		// Reset signal loss timer and Overdue state 					
+		Servo_TCNT2 = TCNT2;
+		RC_Timeout = 0;
+		Overdue = false;
+
+		// Copy unconverted channel data
+		for (j = 0; j < MAX_RC_CHANNELS; j++)
 		{
-			// Work out the expected number of bytes based on the vendor ID (1st byte)
-			if (bytecount == 0)
-			{
-				// Process data when all packets received
-				if (sBuffer[0] == MODEB_SYNCBYTE)		// 12-channel packet
-				{
-					packet_size = XBUS_FRAME_SIZE_12;
-				}
-				else									// Probably a 16-channel packet
-				{
-					packet_size = XBUS_FRAME_SIZE_16;
-				}
-			}
+			// Combine bytes from buffer
+			TempRxChannel[j] = (uint16_t)(sBuffer[(j << 1) + 3] << 8) | (sBuffer[(j << 1) + 4]);
+		}
 
-			// Check checksum when all data received
-			if (bytecount == (packet_size - 1))
-			{
-				crc = 0;
-			
-				// Add up checksum for all bytes up to but not including the checksum
-				for (j = 0; j < (packet_size - 2); j++)
-				{
-					crc = CRC16(crc, sBuffer[j]);
-				}
+		// Convert to system values
+		for (j = 0; j < MAX_RC_CHANNELS; j++)
+		{
+			// Subtract SUMD offset
+			itemp16 = TempRxChannel[j] - 12000;
 			
-				// Extract the packet's own checksum
-				checkcrc = ((uint16_t)(sBuffer[packet_size - 2] << 8) | (uint16_t)(sBuffer[packet_size - 1]));
-				
-				// Compare with the calculated one and process data if ok
-				if (checkcrc == crc)
-				{
-					// RC sync established
-					Interrupted = true;
-					
-					// Reset signal loss timer and Overdue state 					
-					Servo_TCNT2 = TCNT2;
-					RC_Timeout = 0;
-					Overdue = false;
+			// Expand into OpenAero2 units x0.3125 (0.3125)	(1250/4000)
+			// 0.25 + 0.0625 (1/4 + 1/16)
+			itemp16 = (itemp16 >> 2) + (itemp16 >> 4);
+
+			// Add back in OpenAero2 offset
+			RxChannel[Config.Derived.ChannelOrder[j]] = itemp16 + 3750;
+		}
+	}
+	else
+	{
+		RxStats.bad_crc++;
+	}
+
+	return true;
+}
+
+//************************************************************
+//* FlySky IBUS RX Data format 115200Kbit/s, 8 data bit, no parity, and one stop bit. 
+//* One 32 byte frame every 7ms (2778us for a 32 byte packet)
+//*
+//* First byte = frame length	0x20
+//* Second byte = command		0x40	Servo data
+//*
+//* Next 28 bytes = 14 channels of 16-bit servo data, low-byte first
+//* Last 2 bytes = checksum, low-byte first. 0xFFFF minus the sum of the first 30 bytes.
+//*
+//* The data values are the servo pulse width in us.
+//* 
+//* 1000	= 1000us
+//* 1500 	= 1500us +/- 500 for 1-2ms
+//* 2000	= 2000us
+//*
+//************************************************************
+
+bool Decode_IBus(uint8_t temp)
+{
+	int16_t itemp16 = 0;	// Signed temp reg 
+	uint8_t j = 0;			// GP counter
+	uint16_t checkcrc = 0;
+
+	// Add up checksum for all bytes up to but not including the checksum
+	if (bytecount < (IBUS_FRAME_SIZE - 2))
+	{
+		checksum += temp;
+		
+		return false;
+	}
+
+	// Wait for the second checksum byte
+	if (bytecount < (IBUS_FRAME_SIZE - 1))
+	{
+		return false;
+	}
+
+	// Extract the packet's own checksum
+	checkcrc = ((uint16_t)(sBuffer[IBUS_FRAME_SIZE - 1] << 8) | (uint16_t)(sBuffer[IBUS_FRAME_SIZE - 2]));
+
+	// Compare with the calculated one and process servo data if ok
+	if ((sBuffer[1] == IBUS_COMMAND_SERVO) && ((uint16_t)(checkcrc + checksum) == 0xFFFF))
+	{
+		// RC sync established
+		Interrupted = true;
+		RxFrameReady = true;
+		
+		// Reset signal loss timer and Overdue state 					
+		Servo_TCNT2 = TCNT2;
+		RC_Timeout = 0;
+		Overdue = false;
+
+		// Convert to system values
+		for (j = 0; j < MAX_RC_CHANNELS; j++)
+		{
+			// Combine bytes from buffer and subtract IBUS offset
+			itemp16 = ((uint16_t)(sBuffer[(j << 1) + 3] << 8) | (sBuffer[(j << 1) + 2])) - 1500;
 			
-					// Copy unconverted channel data
-					for (j = 0; j < MAX_RC_CHANNELS; j++)
-					{
-						// Combine bytes from buffer
-						TempRxChannel[j] = (uint16_t)(sBuffer[(j << 1) + 1] << 8) | (sBuffer[(j << 1) + 2]);
-					}
-
-					// Convert to system values
-					for (j = 0; j < MAX_RC_CHANNELS; j++)
-					{
-						// Subtract MODEB offset
-						itemp16 = TempRxChannel[j] - 2048;
-						
-						// Expand into OpenAero2 units x0.8544 (0.8555)	(1250/1463)
-						itemp16 = (itemp16 >> 1) + (itemp16 >> 2) + (itemp16 >> 4) + (itemp16 >> 5) + (itemp16 >> 7) + (itemp16 >> 8);
-
-						// Add back in OpenAero2 offset
-						RxChannel[Config.ChannelOrder[j]] = itemp16 + 3750;
-					}
-				}
-			}
-		} // (Config.RxMode == MODEB)
+			// Expand into OpenAero2 units x2.5 (1250/500)
+			itemp16 = (itemp16 << 1) + (itemp16 >> 1);
 
-		//************************************************************
-		//* HoTT SUMD RX Data format 115200Kbit/s, 8 data bit, no parity, and one stop bit. 
-		//* 
-		//* First byte = vendor ID		0xA8 
-		//* Second byte = status		0x01	Valid byte
-		//*								0x81	Valid byte with failsafe bit set
-		//* Third byte			0x02 to 0x20	Number of channels (2 to 32)
-		//*
-		//* Next 2 to 32 bytes = n channels of 16-bit servo data, high-byte first
-		//* Last 2 bytes = CRC value over first n*2 + 3 bytes (data + header), using CRC-CCITT algorithm.
-		//*
-		//* Pulse length conversion from [0...4095] to s:
-		//*      900s  -> 0x1c20 (7200)
-		//*      1500s -> 0x2ee0 (12000)
-		//*      2100s -> 0x41a0 (16800)
-		//*
-		//* Total range is: 16800 - 7200 = 9600 or +/-4800 bits and +/- 600us
-		//*
-		//* The data values can range from 7200 to 16800 to define a servo pulse width.
-		//* Each bit in servo data corresponds to pulse width change of 125ns or 0.125us. 
-		//* 
-		//* 8000	= 1000us
-		//* 12000 	= 1500us +/- 4000 for 1-2ms
-		//* 16000	= 2000us
-		//*
-		//************************************************************
+			// Add back in OpenAero2 offset
+			RxChannel[Config.Derived.ChannelOrder[j]] = itemp16 + 3750;
+		}
+	}
+	else
+	{
+		RxStats.bad_crc++;
+	}
+
+	return true;
+}
+
+//************************************************************
+//* TBS Crossfire CRSF RX Data format 420Kbit/s, 8 data bit, no parity, and one stop bit. 
+//* One 26 byte RC frame every 4ms or faster (620us for a 26 byte packet)
+//* Other frame types (link statistics etc.) are interleaved and ignored.
+//*
+//* First byte = address		0xC8	Flight controller
+//* Second byte = length		Number of bytes that follow, including type and CRC (2 to 62)
+//* Third byte = type			0x16	RC channels packed
+//*
+//* Next 22 bytes = 16 channels of 11-bit servo data, packed LSB first
+//* Last byte = CRC8 (DVB-S2) over type and payload bytes
+//*
+//* Data size:	172 to 1811, centered on 992 (1.500ms) 0.625us/bit
+//* 
+//* 172		= 988us
+//* 992 	= 1500us +/-800 for 1-2ms (OAV = +/-1250)
+//* 1811	= 2012us
+//*
+//************************************************************
+
+bool Decode_CRSF(uint8_t temp)
+{
+	int16_t itemp16 = 0;	// Signed temp reg 
+	uint8_t sindex = 0;		// Serial buffer index
+	uint8_t j = 0;			// GP counter
+	uint8_t bits = 0;		// Number of unused bits in bitbuffer
+	uint32_t bitbuffer = 0;
+
+	// Address byte
+	if (bytecount == 0)
+	{
+		return false;
+	}
+	
+	// Work out the expected number of bytes based on the length (2nd byte)
+	if (bytecount == 1)
+	{
+		packet_size = temp + 2;
+
+		// Sanity check for packet size. Drop the frame if impossible.
+		if ((temp < 2) || (packet_size > CRSF_MAX_FRAME))
+		{
+			return true;
+		}
+
+		return false;
+	}
+
+	// Add up CRC for type and payload bytes
+	if (bytecount < (packet_size - 1))
+	{
+		checksum = CRC8_DVB_S2((uint8_t)checksum, temp);
 		
-		// Handle HoTT SUMD format
-		if (Config.RxMode == SUMD)
+		return false;
+	}
+
+	// Compare with the packet's own CRC
+	if ((uint8_t)checksum != temp)
+	{
+		RxStats.bad_crc++;
+	}
+
+	// Process RC frames if ok
+	else if (sBuffer[2] == CRSF_FRAME_RC_CHANNELS)
+	{
+		// RC sync established
+		Interrupted = true;
+		RxFrameReady = true;
+		
+		// Reset signal loss timer and Overdue state 					
+		Servo_TCNT2 = TCNT2;
+		RC_Timeout = 0;
+		Overdue = false;
+
+		// Start from fourth byte
+		sindex = 3;
+
+		// Deconstruct CRSF data
+		for (j = 0; j < MAX_RC_CHANNELS; j++)
 		{
-			// Work out the expected number of bytes based on the channel info (3rd byte)
-			if (bytecount == 2)
+			// Top up bit buffer until it holds one channel's data (11 bits)
+			while (bits < 11)
 			{
-				// Look at the number of channels x 2 + 2(CRC) + 3(Header)
-				packet_size = (sBuffer[2] << 1) + 5;
-				
-				// Sanity check for packet size
-				if (packet_size > MAXSUMDPACKET)
-				{
-					packet_size = MAXSUMDPACKET;
-				}
+				bitbuffer |= (uint32_t)sBuffer[sindex++] << bits;
+				bits += 8;
 			}
 
-			// Check checksum when all data received and packet size determined
-			if ((packet_size > 0) && (bytecount == (packet_size - 1)))
-			{
-				crc = 0;
-			
-				// Add up checksum for all bytes up to but not including the checksum
-				for (j = 0; j < (packet_size - 2); j++)
-				{
-					crc = CRC16(crc, sBuffer[j]);
-				}
-			
-				// Extract the packet's own checksum
-				checkcrc = ((uint16_t)(sBuffer[packet_size - 2] << 8) | (uint16_t)(sBuffer[packet_size - 1]));
+			// Subtract CRSF offset
+			itemp16 = (int16_t)(bitbuffer & 0x7FF) - 992;
+			bitbuffer >>= 11;
+			bits -= 11;
 				
-				// Compare with the calculated one and process data if ok
-				if (checkcrc == crc)
-				{
-					// RC sync established
-					Interrupted = true;
-					
-					// Reset signal loss timer and Overdue state 					
-					Servo_TCNT2 = TCNT2;
-					RC_Timeout = 0;
-					Overdue = false;
-			
-					// Copy unconverted channel data
-					for (j = 0; j < MAX_RC_CHANNELS; j++)
-					{
-						// Combine bytes from buffer
-						TempRxChannel[j] = (uint16_t)(sBuffer[(j << 1) + 3] << 8) | (sBuffer[(j << 1) + 4]);
-					}
-
-					// Convert to system values
-					for (j = 0; j < MAX_RC_CHANNELS; j++)
-					{
-						// Subtract SUMD offset
-						itemp16 = TempRxChannel[j] - 12000;
-						
-						// Expand into OpenAero2 units x0.3125 (0.3125)	(1250/4000)
-						// 0.25 + 0.0625 (1/4 + 1/16)
-						itemp16 = (itemp16 >> 2) + (itemp16 >> 4);
-
-						// Add back in OpenAero2 offset
-						RxChannel[Config.ChannelOrder[j]] = itemp16 + 3750;
-					}
-				}
-			}
-		} // (Config.RxMode == SUMD)
+			// Expand into OpenAero2 units x1.562 (1.5625) (1250/800)
+			itemp16 = itemp16 + (itemp16 >> 1) + (itemp16 >> 4);
 
-		//************************************************************
-		//* Common exit code
-		//************************************************************
+			// Add back in OpenAero2 offset
+			RxChannel[Config.Derived.ChannelOrder[j]] = itemp16 + 3750;
+		}
+	}
 
-		// Increment byte count
-		bytecount++;
-	
-	} // Valid data
+	return true;
 }
 
 //***********************************************************
@@ -1002,13 +1325,17 @@ void init_int(void)
 			break;
 
 		case PWM:
-			PCMSK1 |= (1 << PCINT8);			// PB0 (Aux pin change mask)
-			PCMSK3 |= (1 << PCINT24);			// PD0 (Throttle pin change mask)
-			EIMSK  = 0x07;						// Enable INT0, 1 and 2 
+			PWM_PortB_Old = PINB;				// Snapshot pins so the first edge is seen correctly
+			PWM_PortD_Old = PIND;
+			PCMSK1 |= (1 << PCINT8) | (1 << PCINT10);					// PB0, PB2 (Aux, Rudder pin change mask)
+			PCMSK3 |= (1 << PCINT24) | (1 << PCINT26) | (1 << PCINT27);	// PD0, PD2, PD3 (Throttle, Elevator, Aileron pin change mask)
+			EIMSK  = 0;							// INT0, 1 and 2 not used in PWM mode
 			UCSR0B &= ~(1 << RXCIE0);			// Disable serial interrupt
 			UCSR0B &= ~(1 << RXEN0);			// Disable receiver and flush buffer
 			break;
 
+		case CRSF:
+		case IBUS:
 		case SUMD:
 		case MODEB:
 		case XTREME:
@@ -1020,6 +1347,7 @@ void init_int(void)
 			EIMSK  = 0;							// Disable INT0, 1 and 2 
 			
 			// Enable serial receiver and interrupts
+			// init_uart() must have set up the baud rate and SerialRX decoder first
 			UCSR0B |= (1 << RXCIE0);			// Enable serial interrupt
 			UCSR0B |= (1 << RXEN0);				// Enable receiver
 			
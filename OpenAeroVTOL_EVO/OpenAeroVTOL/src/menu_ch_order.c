@@ -97,10 +97,7 @@ void menu_channel(void)
 		// Update when exiting
 		if (button == ENTER)
 		{
-			// Refresh channel order
-			UpdateChOrder();
-			
-			Save_Config_to_EEPROM(); // Save value and return
+			UpdateDerived();		 // Refresh channel order if it changed, then save
 			Wait_BUTTON4();			 // Wait for user's finger off the button
 		}
 	}
@@ -23,7 +23,7 @@
 #include <avr/interrupt.h>
 #include "mixer.h"
 
-#define CONTRAST 160 // Contrast item number <--- This sucks... move somewhere sensible!!!!!
+#define CONTRAST 498 // Contrast item number <--- This sucks... move somewhere sensible!!!!!
 
 //************************************************************
 // Prototypes
@@ -445,7 +445,12 @@ void do_menu_item(uint16_t menuitem, int8_t *values, uint8_t mult, menu_range_t
 		value = value / mult;
 	}
 
-	*values = (int8_t)value;
+	// Flag what needs rebuilding only if the setting really changed
+	if (*values != (int8_t)value)
+	{
+		*values = (int8_t)value;
+		Mark_config_dirty(values);
+	}
 }
 
 //************************************************************
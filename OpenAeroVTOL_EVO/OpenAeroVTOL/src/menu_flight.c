@@ -132,8 +132,7 @@ void menu_flight(uint8_t mode)
 		// Update limits when exiting
 		if (button == ENTER)
 		{
-			UpdateLimits();			 // Update I-term limits and triggers based on percentages
-			Save_Config_to_EEPROM(); // Save value and return
+			UpdateDerived();		 // Update I-term limits and trims if they changed, then save
 			Wait_BUTTON4();			 // Wait for user's finger off the button
 		}
 	}
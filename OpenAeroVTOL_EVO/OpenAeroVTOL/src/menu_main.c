@@ -34,9 +34,9 @@ void Wait_BUTTON4(void);
 //************************************************************
 
 #ifdef ERROR_LOG
-#define MAINITEMS 24	// Number of menu items
+#define MAINITEMS 25	// Number of menu items
 #else
-#define MAINITEMS 23	// Number of menu items
+#define MAINITEMS 24	// Number of menu items
 #endif
 
 #define MAINSTART 77	// Start of Menu text items
@@ -180,7 +180,10 @@ void do_main_menu_item(uint8_t menuitem)
 			Display_in_out();		// 23.IO menu
 			break;
 		case MAINSTART+23:
-			menu_log();				// 24.Error log
+			menu_models();			// 24.Models
+			break;
+		case MAINSTART+24:
+			menu_log();				// 25.Error log
 			break;
 		default:
 			break;	
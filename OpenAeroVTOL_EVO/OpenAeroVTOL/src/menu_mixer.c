@@ -181,8 +181,7 @@ void menu_mixer(uint8_t i)
 		// Update limits when exiting
 		if (button == ENTER)
 		{
-			UpdateLimits();			 // Update travel limits based on percentages
-			Save_Config_to_EEPROM(); // Save value and return
+			UpdateDerived();		 // Mixer settings are used directly, so this just saves
 			Wait_BUTTON4();			 // Wait for user's finger off the button
 		}
 	}
@@ -0,0 +1,131 @@
+//***********************************************************
+//* menu_models.c
+//***********************************************************
+
+//***********************************************************
+//* Includes
+//***********************************************************
+
+#include <avr/pgmspace.h>
+#include <avr/io.h>
+#include <stdbool.h>
+#include <util/delay.h>
+#include "io_cfg.h"
+#include "init.h"
+#include "mugui.h"
+#include "glcd_menu.h"
+#include "menu_ext.h"
+#include "glcd_driver.h"
+#include "main.h"
+#include "eeprom.h"
+#include "mixer.h"
+#include "uart.h"
+#include "isr.h"
+
+//************************************************************
+// Prototypes
+//************************************************************
+
+// Menu items
+void menu_models(void);
+
+//************************************************************
+// Defines
+//************************************************************
+
+#define MODELSTART 521			// Start of Menu text items (Load model 1 to Save model 4)
+#define MODELITEMS (MODELS * 2)	// Number of menu items
+#define MODELEMPTY 529			// "Empty"
+#define MODELNOROOM 530			// "No room"
+#define MODELOFFSET 90			// LCD offset for the "Empty" text
+
+//************************************************************
+// Model memory menu
+//************************************************************
+
+void menu_models(void)
+{
+	uint8_t	used = 0;
+	uint8_t	model;
+	uint8_t	i;
+
+	// If sub-menu item has changed, reset sub-menu positions
+	if (menu_flag)
+	{
+		sub_top = MODELSTART;
+		menu_flag = 0;
+	}
+
+	// Find which memories hold a model
+	for (i = 0; i < MODELS; i++)
+	{
+		if (Check_model(i))
+		{
+			used |= (1 << i);
+		}
+	}
+
+	while(button != BACK)
+	{
+		// Clear buffer before each update
+		clear_buffer(buffer);
+
+		// Print menu
+		print_menu_frame(BASIC);
+
+		for (i = 0; i < 4; i++)
+		{
+			LCD_Display_Text(sub_top + i,(const unsigned char*)Verdana8,ITEMOFFSET,(uint8_t)pgm_read_byte(&lines[i]));
+
+			// Mark the empty memories
+			model = (sub_top + i - MODELSTART) % MODELS;
+
+			if (!(used & (1 << model)))
+			{
+				LCD_Display_Text(MODELEMPTY,(const unsigned char*)Verdana8,MODELOFFSET,(uint8_t)pgm_read_byte(&lines[i]));
+			}
+		}
+
+		print_cursor(cursor);
+		write_buffer(buffer);
+
+		// Poll buttons when idle
+		poll_buttons(true);
+
+		// Handle menu changes
+		update_menu(MODELITEMS, MODELSTART, 0, button, &cursor, &sub_top, &menu_temp);
+
+		if (button == ENTER)
+		{
+			model = (menu_temp - MODELSTART) % MODELS;
+
+			// Load model
+			if (menu_temp < (MODELSTART + MODELS))
+			{
+				if (Load_model(model))
+				{
+					init_uart();			// In case RC type has changed, reinitialise UART
+					init_int();				// and interrupts
+					UpdateLimits();			// Work out the derived values, disarm if ARMABLE and save in the background
+				}
+			}
+			// Save model
+			else
+			{
+				if (Save_model(model))
+				{
+					used |= (1 << model);
+				}
+				else
+				{
+					clear_buffer(buffer);
+					LCD_Display_Text(MODELNOROOM,(const unsigned char*)Verdana14,28,25); // "No room"
+					write_buffer(buffer);
+					_delay_ms(1000);
+				}
+			}
+
+			Wait_BUTTON4();			 // Wait for user's finger off the button
+		}
+	}
+}
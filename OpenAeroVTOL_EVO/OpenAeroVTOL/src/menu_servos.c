@@ -133,6 +133,7 @@ void menu_servo_setup(uint8_t section)
 			if (zero_setting)
 			{
 				value_ptr[menu_temp - SERVOSTART] = 0;
+				Mark_config_dirty(&value_ptr[menu_temp - SERVOSTART]);
 			}
 
 			// Do not allow servo enable for throttle if in CPPM mode
@@ -149,8 +150,7 @@ void menu_servo_setup(uint8_t section)
 
 		if (button == ENTER)
 		{
-			UpdateLimits();				// Update actual servo trims
-			Save_Config_to_EEPROM();	// Save value and return
+			UpdateDerived();			// Update actual servo limits if they changed, then save
 			Wait_BUTTON4();				// Wait for user's finger off the button
 		}
 	}
@@ -41,38 +41,39 @@ void menu_rc_setup(uint8_t section);
 //************************************************************
 
 #define RCSTART 146 	// Start of Menu text items
-#define RCTEXT 396 		// Start of "Receiver type" value text list
+#define RCTEXT 392 		// Start of "Receiver type" value text list
 #define RCITEMS 12 		// Number of menu items displayed	
-#define RCITEMSOFFSET 12// Actual number of menu items
 #define RCOFFSET 65		// LCD offsets
 
+#define GENERALSTART 496// Start of General menu text items
 #define GENERALTEXT	295 // Start of "Orientations" value text list
-#define GENERALITEMS 12	// Number of menu items displayed
+#define GENERALITEMS 15	// Number of menu items displayed
 #define GENOFFSET 70	// LCD offsets
 
-#define PRESETITEM 171	// Location of Preset menu item in list
+#define PRESETITEM (GENERALSTART + 10)	// Location of Preset menu item in list
 
 //************************************************************
 // RC menu items
 //************************************************************
 	 
-const uint16_t RCMenuText[2][RCITEMS] PROGMEM = 
+// Arrays are sized for the longer General menu
+const uint16_t RCMenuText[2][GENERALITEMS] PROGMEM = 
 {
 	{RCTEXT, 118, 105, 130, 105, 0, 0, 0, 0, 0, 68, 0},				// RC setup
-	{GENERALTEXT, 320, 0, 53, 0, 0, 37, 37, 37, 0, 273, 68},		// General 
+	{GENERALTEXT, 320, 0, 53, 0, 0, 37, 37, 37, 0, 273, 68, 0, 0, 0},// General 
 };
 
-const uint16_t RCMenuOffsets[2][RCITEMS] PROGMEM =
+const uint16_t RCMenuOffsets[2][GENERALITEMS] PROGMEM =
 {
 	{RCOFFSET, 65, 65, 60, 75, 95, 95, 95, 95, 95, 95, 95},			// RC setup
-	{GENOFFSET, 67, 67, 67, 80, 80, 80, 80, 80, 80, 80, 80},		// General
+	{GENOFFSET, 67, 67, 67, 80, 80, 80, 80, 80, 80, 80, 80, 80, 80, 80},// General
 };
 
-const menu_range_t rc_menu_ranges[2][RCITEMS] PROGMEM = 
+const menu_range_t rc_menu_ranges[2][GENERALITEMS] PROGMEM = 
 {
 	{
 		// RC setup (12)				// Min, Max, Increment, Style, Default
-		{CPPM_MODE,SUMD,1,1,SBUS},		// Receiver type (PWM to SUMD)	
+		{CPPM_MODE,CRSF,1,1,SBUS},		// Receiver type (CPPM to CRSF)	
 		{LOW,FAST,1,1,FAST},			// Servo rate
 		{THROTTLE,GEAR,1,1,GEAR},		// PWM sync channel
 		{JRSEQ,CUSTOM,1,1,JRSEQ},		// Channel order
@@ -86,7 +87,7 @@ const menu_range_t rc_menu_ranges[2][RCITEMS] PROGMEM =
 		{0,127,1,0,20},					// AccVert filter in 1/100th %
 	},
 	{
-		// General (12)
+		// General (15)
 		{UP_BACK,RIGHT_FRONT,1,1,UP_BACK},	// Orientation (P2)
 		{NO_ORIENT,MODEL,1,1,NO_ORIENT},	// Orientation usage (Tail sitter)
 		// Limit contrast range for KK2 Mini
@@ -104,6 +105,9 @@ const menu_range_t rc_menu_ranges[2][RCITEMS] PROGMEM =
 		{2,11,1,0,6},					// AL correction
 		{QUADX,BLANK,1,4,QUADX},		// Mixer preset (note: style 4)
 		{OFF,ON,1,1,ON},				// Buzzer ON/OFF
+		{-45,45,1,0,0},					// Board roll alignment (degrees)
+		{-45,45,1,0,0},					// Board pitch alignment (degrees)
+		{-45,45,1,0,0},					// Board yaw alignment (degrees)
 	}
 };
 
@@ -147,7 +151,7 @@ void menu_rc_setup(uint8_t section)
 			case 1:				// RC setup menu
 				break;
 			case 2:				// General menu
-				offset = RCITEMSOFFSET;
+				offset = GENERALSTART - RCSTART;
 				items = GENERALITEMS;
 				value_ptr = &Config.Orientation_P2;
 				break;
@@ -190,42 +194,18 @@ void menu_rc_setup(uint8_t section)
 		// Post-processing on exit
 		if (button == ENTER)
 		{
-			init_int();				// In case RC type has changed, reinitialise interrupts
-			init_uart();			// and UART
-			UpdateLimits();			// Update I-term limits and triggers based on percentages
-			
-			// See if mixer preset has changed. Load new preset only if so
-			if ((Config.Preset != OPTIONS) && (menu_temp == PRESETITEM))
-			{
-				Load_eeprom_preset(Config.Preset);
-			}
-
-			// Update MPU6050 LPF and reverse sense of menu items
-			writeI2Cbyte(MPU60X0_DEFAULT_ADDRESS, MPU60X0_RA_CONFIG, (6 - Config.MPU6050_LPF));
-
-			// Refresh channel order
-			UpdateChOrder();
-
-			// Check validity of RX type and PWM speed selection
-			// If illegal setting, drop down to RC Sync
-			if ((Config.RxMode < SBUS) && (Config.Servo_rate == FAST))
+			// In case RC type has changed, reinitialise UART and interrupts.
+			// The UART goes first so that RX interrupts never run the old decoder at the new baud rate.
+			if (Config_dirty & (1 << RxDirty))
 			{
-				Config.Servo_rate = SYNC;
+				init_uart();
+				init_int();
 			}
-						
-			if (Config.ArmMode == ARMABLE)
-			{
-				General_error |= (1 << DISARMED);	// Set flags to disarmed
-				LED1 = 0;
-			}
-
-			// Work out the P1 orientation from the user's P2 orientation setting
-			Config.Orientation_P1 = (int8_t)pgm_read_byte(&P1_Orientation_LUT[Config.Orientation_P2]);
-
-			// Return the preset to "Options" when going back to the General menu
-			Config.Preset = OPTIONS;
 
-			Save_Config_to_EEPROM(); // Save value and return
+			// Loads a new preset, checks the servo rate and disarms if ARMABLE, then
+			// rebuilds the channel order, LPFs, orientation and triggers if they changed.
+			// The preset is returned to "Options" for the General menu.
+			UpdateDerived();
 			
 			Wait_BUTTON4();			 // Wait for user's finger off the button
 		}
@@ -8,6 +8,7 @@
 
 #include "compiledefs.h"
 #include <string.h>
+#include <stddef.h>
 #include <avr/io.h>
 #include <stdbool.h>
 #include <util/delay.h>
@@ -25,6 +26,7 @@
 #include "eeprom.h"
 #include "i2c.h"
 #include "MPU6050.h"
+#include "gyros.h"
 
 //************************************************************
 // Prototypes
@@ -33,6 +35,8 @@
 void ProcessMixer(void);
 void UpdateServos(void);
 void UpdateLimits(void);
+void UpdateDerived(void);
+void Mark_config_dirty(void* setting);
 void get_preset_mix (const channel_t*);
 int16_t scale32(int16_t value16, int16_t multiplier16);
 int16_t scale_percent(int8_t value);
@@ -51,6 +55,7 @@ int16_t	P1_curve_C = 0;		// Generic curve C
 int16_t	P2_curve_C = 0;		// Generic curve C
 int16_t	P1_curve_D = 0;		// Generic curve D
 int16_t	P2_curve_D = 0;		// Generic curve D
+uint8_t	Config_dirty = 0;	// Derived values waiting to be rebuilt (DerivedFlags)
 
 //************************************************************
 // Defines
@@ -58,6 +63,24 @@ int16_t	P2_curve_D = 0;		// Generic curve D
 
 #define MIX_OUTPUTS 8
 
+// The settings that each group of derived values is worked out from.
+// Settings not listed here are used directly and need no rebuild.
+const config_dep_t ConfigDeps[] PROGMEM = 
+{
+	{offsetof(CONFIG_STRUCT, RxMode),				offsetof(CONFIG_STRUCT, TxSeq),				(1 << RxDirty) | (1 << FiltersDirty)},	// RxMode, Servo_rate, PWM_Sync
+	{offsetof(CONFIG_STRUCT, TxSeq),				offsetof(CONFIG_STRUCT, FlightChan),		(1 << ChOrderDirty)},
+	{offsetof(CONFIG_STRUCT, FlightMode),			offsetof(CONFIG_STRUCT, Orientation_P2),	(1 << ProfileDirty)},					// I-term limits and trims
+	{offsetof(CONFIG_STRUCT, Orientation_P2),		offsetof(CONFIG_STRUCT, P1_Reference),		(1 << OrientDirty)},
+	{offsetof(CONFIG_STRUCT, PowerTrigger),			offsetof(CONFIG_STRUCT, MPU6050_LPF),		(1 << TriggerDirty)},
+	{offsetof(CONFIG_STRUCT, MPU6050_LPF),			offsetof(CONFIG_STRUCT, CF_factor),			(1 << FiltersDirty)},					// MPU6050, acc and gyro LPFs
+	{offsetof(CONFIG_STRUCT, BoardAngle),			offsetof(CONFIG_STRUCT, Channel),			(1 << OrientDirty)},
+	{offsetof(CONFIG_STRUCT, min_travel),			offsetof(CONFIG_STRUCT, RxChannelZeroOffset),(1 << TravelDirty)},
+	{offsetof(CONFIG_STRUCT, Orientation_P1),		offsetof(CONFIG_STRUCT, Curve),				(1 << OrientDirty)},
+	{offsetof(CONFIG_STRUCT, CustomChannelOrder),	offsetof(CONFIG_STRUCT, Offsets),			(1 << ChOrderDirty)},
+};
+
+#define CONFIG_DEPS (sizeof(ConfigDeps) / sizeof(config_dep_t))
+
 // Throttle volume curves
 // Why 101 steps? Well, both 0% and 100% transition values are valid...
 
@@ -554,8 +577,8 @@ void ProcessMixer(void)
 		}
 			
 		// Save solution for this channel. Note that this contains cross-mixed data from the *last* cycle
-		Config.Channel[i].P1_value = P1_solution;
-		Config.Channel[i].P2_value = P2_solution;
+		Config.Derived.P1_value[i] = P1_solution;
+		Config.Derived.P2_value[i] = P2_solution;
 
 	} // Mixer loop: for (i = 0; i < MIX_OUTPUTS; i++)
 
@@ -576,27 +599,27 @@ void ProcessMixer(void)
 		// Speed up the easy ones :)
 		if (transition == 0)
 		{
-			temp1 = Config.Channel[i].P1_value;
+			temp1 = Config.Derived.P1_value[i];
 		}
 		else if (transition >= 100)
 		{
-			temp1 = Config.Channel[i].P2_value;
+			temp1 = Config.Derived.P2_value[i];
 		}
 		else
 		{
 			// Get source channel value
-			temp1 = Config.Channel[i].P1_value;
+			temp1 = Config.Derived.P1_value[i];
 			temp1 = scale32(temp1, (100 - transition));
 
 			// Get destination channel value
-			temp2 = Config.Channel[i].P2_value;
+			temp2 = Config.Derived.P2_value[i];
 			temp2 = scale32(temp2, transition);
 
 			// Sum the mixers
 			temp1 = temp1 + temp2;
 		}
 		// Save transitioned solution into P1
-		Config.Channel[i].P1_value = temp1;
+		Config.Derived.P1_value[i] = temp1;
 	}  
 
 	//************************************************************
@@ -745,14 +768,14 @@ void ProcessMixer(void)
 			temp3 = temp3 - THROTTLEMIN;
 
 			// Add offset to channel value
-			Config.Channel[i].P1_value += temp3;
+			Config.Derived.P1_value[i] += temp3;
 
 		} // No throttle
 		
 		// No throttles, so clamp to THROTTLEMIN if flagged as a motor
 		else if (Config.Channel[i].Motor_marker == MOTOR)
 		{
-			Config.Channel[i].P1_value = -THROTTLEOFFSET; // 3750-1250 = 2500 = 1.0ms. THROTTLEOFFSET = 1250
+			Config.Derived.P1_value[i] = -THROTTLEOFFSET; // 3750-1250 = 2500 = 1.0ms. THROTTLEOFFSET = 1250
 		}
 	}
 
@@ -772,7 +795,7 @@ void ProcessMixer(void)
 		temp2 = Process_curve(i + NUMBEROFCURVES, BIPOLAR, temp1);
 		
 		// Add offset to channel value
-		Config.Channel[i].P1_value += temp2;
+		Config.Derived.P1_value[i] += temp2;
 	}
 
 } // ProcessMixer()
@@ -785,6 +808,29 @@ void ProcessMixer(void)
 // This is only done at start-up and whenever the values are changed
 // so as to reduce CPU loop load
 void UpdateLimits(void)
+{
+	// Rebuild everything
+	Config_dirty = 0xFF;
+	UpdateDerived();
+}
+
+// Flag the derived values that depend on the setting at "setting"
+void Mark_config_dirty(void* setting)
+{
+	uint16_t offset = (uint16_t)((uint8_t*)setting - (uint8_t*)&Config);
+	uint8_t i;
+
+	for (i = 0; i < CONFIG_DEPS; i++)
+	{
+		if ((offset >= pgm_read_word(&ConfigDeps[i].start)) && (offset < pgm_read_word(&ConfigDeps[i].end)))
+		{
+			Config_dirty |= pgm_read_byte(&ConfigDeps[i].derived);
+		}
+	}
+}
+
+// Rebuild only the derived values flagged in Config_dirty
+void UpdateDerived(void)
 {
 	uint8_t i,j;
 	int32_t temp32, gain32;
@@ -803,153 +849,173 @@ void UpdateLimits(void)
 			{Config.FlightMode[P2].Roll_I_mult, Config.FlightMode[P2].Pitch_I_mult, Config.FlightMode[P2].Yaw_I_mult, Config.FlightMode[P2].A_Zed_I_mult}
 		};
 
-	// Update LVA trigger
-	// Vbat is measured in units of 10mV, so PowerTriggerActual of 1270 equates to 12.7V
-	switch (Config.PowerTrigger)
-	{
-		case 0:
-			Config.PowerTriggerActual = 0;			// Off
-			break;
-		case 1:
-			Config.PowerTriggerActual = 320; 		// 3.2V
-			break;
-		case 2:
-			Config.PowerTriggerActual = 330; 		// 3.3V
-			break;
-		case 3:
-			Config.PowerTriggerActual = 340;		// 3.4V
-			break;
-		case 4:
-			Config.PowerTriggerActual = 350; 		// 3.5V
-			break;
-		case 5:
-			Config.PowerTriggerActual = 360; 		// 3.6V
-			break;
-		case 6:
-			Config.PowerTriggerActual = 370; 		// 3.7V
-			break;
-		case 7:
-			Config.PowerTriggerActual = 380; 		// 3.8V
-			break;
-		case 8:
-			Config.PowerTriggerActual = 390; 		// 3.9V
-			break;
-		default:
-			Config.PowerTriggerActual = 0;			// Off
-			break;
-	}
-			
-	// Determine cell count and use to multiply trigger
-	if (SystemVoltage >= 2150)										// 6S - 21.5V or at least 3.58V per cell
-	{
-		Config.PowerTriggerActual *= 6;
-	}
-	else if ((SystemVoltage >= 1730) && (SystemVoltage < 2150))		// 5S 17.3V to 21.5V or 4.32V(4S) to 3.58V(6S) per cell
-	{
-		Config.PowerTriggerActual *= 5;
-	}
-	else if ((SystemVoltage >= 1300) && (SystemVoltage < 1730))		// 4S 13.0V to 17.3V or 4.33V(3S) to 3.46V(5S) per cell
+	// See if mixer preset has changed. The only time it will ever NOT
+	// be "Options" is when the GUI or the General menu has changed it.
+	if (Config.Preset != OPTIONS)
 	{
-		Config.PowerTriggerActual *= 4;
+		Load_eeprom_preset(Config.Preset);
+		
+		// Reset the mixer preset
+		Config.Preset = OPTIONS;
+		Config_dirty |= ((1 << ProfileDirty) | (1 << TravelDirty));
 	}
-	else if ((SystemVoltage >= 900) && (SystemVoltage < 1300))		// 3S 9.0V to 13.0V or 4.5V(2S) to 3.25V(4S) per cell
+
+	// Check validity of RX type and PWM speed selection
+	// If illegal setting, drop down to RC Sync
+	if ((Config.RxMode < SBUS) && (Config.Servo_rate == FAST))
 	{
-		Config.PowerTriggerActual *= 3;
+		Config.Servo_rate = SYNC;
+		Config_dirty |= (1 << FiltersDirty);
 	}
-	else if (SystemVoltage < 900)									// 2S Under 9.0V or 3.0V(3S) per cell
+
+	// Update LVA trigger
+	// Vbat is measured in units of 10mV, so PowerTriggerActual of 1270 equates to 12.7V
+	if (Config_dirty & (1 << TriggerDirty))
 	{
-		Config.PowerTriggerActual *= 2;
+		switch (Config.PowerTrigger)
+		{
+			case 0:
+				Config.Derived.PowerTriggerActual = 0;			// Off
+				break;
+			case 1:
+				Config.Derived.PowerTriggerActual = 320; 		// 3.2V
+				break;
+			case 2:
+				Config.Derived.PowerTriggerActual = 330; 		// 3.3V
+				break;
+			case 3:
+				Config.Derived.PowerTriggerActual = 340;		// 3.4V
+				break;
+			case 4:
+				Config.Derived.PowerTriggerActual = 350; 		// 3.5V
+				break;
+			case 5:
+				Config.Derived.PowerTriggerActual = 360; 		// 3.6V
+				break;
+			case 6:
+				Config.Derived.PowerTriggerActual = 370; 		// 3.7V
+				break;
+			case 7:
+				Config.Derived.PowerTriggerActual = 380; 		// 3.8V
+				break;
+			case 8:
+				Config.Derived.PowerTriggerActual = 390; 		// 3.9V
+				break;
+			default:
+				Config.Derived.PowerTriggerActual = 0;			// Off
+				break;
+		}
+			
+		// Determine cell count and use to multiply trigger
+		if (SystemVoltage >= 2150)										// 6S - 21.5V or at least 3.58V per cell
+		{
+			Config.Derived.PowerTriggerActual *= 6;
+		}
+		else if ((SystemVoltage >= 1730) && (SystemVoltage < 2150))		// 5S 17.3V to 21.5V or 4.32V(4S) to 3.58V(6S) per cell
+		{
+			Config.Derived.PowerTriggerActual *= 5;
+		}
+		else if ((SystemVoltage >= 1300) && (SystemVoltage < 1730))		// 4S 13.0V to 17.3V or 4.33V(3S) to 3.46V(5S) per cell
+		{
+			Config.Derived.PowerTriggerActual *= 4;
+		}
+		else if ((SystemVoltage >= 900) && (SystemVoltage < 1300))		// 3S 9.0V to 13.0V or 4.5V(2S) to 3.25V(4S) per cell
+		{
+			Config.Derived.PowerTriggerActual *= 3;
+		}
+		else if (SystemVoltage < 900)									// 2S Under 9.0V or 3.0V(3S) per cell
+		{
+			Config.Derived.PowerTriggerActual *= 2;
+		}
 	}
 
-	// Update I_term input constraints for all profiles
-	for (j = 0; j < FLIGHT_MODES; j++)
+	if (Config_dirty & (1 << ProfileDirty))
 	{
-		// Limits calculation is different for gyros and accs
-		for (i = 0; i < (NUMBEROFAXIS); i++)
+		// Update I_term input constraints for all profiles
+		for (j = 0; j < FLIGHT_MODES; j++)
 		{
-			temp32 	= limits[j][i]; 						// Promote limit %
+			// Limits calculation is different for gyros and accs
+			for (i = 0; i < (NUMBEROFAXIS); i++)
+			{
+				temp32 	= limits[j][i]; 						// Promote limit %
+
+				// I-term output (throw). Convert from % to actual count
+				// A value of 80,000 results in +/- 1250 or full throw at the output stage
+				// This is because the maximum signal value is +/-1250 after division by 64. 1250 * 64 = 80,000
+				Config.Derived.Raw_I_Limits[j][i] = temp32 * (int32_t)640;	// 80,000 / 125% = 640
+
+				// I-term source limits. These have to be different due to the I-term gain setting
+				// I-term = (gyro * gain) / 32, so the gyro count for a particular gain and limit is
+				// Gyro = (I-term * 32) / gain :) 
+				if (gains[j][i] != 0)
+				{
+					gain32 = gains[j][i];						// Promote gain value
+					Config.Derived.Raw_I_Constrain[j][i] = (Config.Derived.Raw_I_Limits[j][i] << 5) / gain32;
+				}
+				else 
+				{
+					Config.Derived.Raw_I_Constrain[j][i] = 0;
+				}
+			}
+		
+			// Accs
+			temp32 	= limits[j][ZED]; 						// Promote limit %
 
 			// I-term output (throw). Convert from % to actual count
 			// A value of 80,000 results in +/- 1250 or full throw at the output stage
 			// This is because the maximum signal value is +/-1250 after division by 64. 1250 * 64 = 80,000
-			Config.Raw_I_Limits[j][i] = temp32 * (int32_t)640;	// 80,000 / 125% = 640
+			Config.Derived.Raw_I_Limits[j][ZED] = temp32 * (int32_t)640;	// 80,000 / 125% = 640
 
 			// I-term source limits. These have to be different due to the I-term gain setting
-			// I-term = (gyro * gain) / 32, so the gyro count for a particular gain and limit is
-			// Gyro = (I-term * 32) / gain :) 
-			if (gains[j][i] != 0)
+			// I-term = (gyro * gain) / 4, so the gyro count for a particular gain and limit is
+			// Gyro = (I-term * 4) / gain :)
+			if (gains[j][ZED] != 0)
 			{
-				gain32 = gains[j][i];						// Promote gain value
-				Config.Raw_I_Constrain[j][i] = (Config.Raw_I_Limits[j][i] << 5) / gain32;
+				gain32 = gains[j][ZED];						// Promote gain value
+				Config.Derived.Raw_I_Constrain[j][ZED] = (Config.Derived.Raw_I_Limits[j][ZED] << 2) / gain32;
 			}
-			else 
+			else
 			{
-				Config.Raw_I_Constrain[j][i] = 0;
-			}
-		}
-		
-		// Accs
-		temp32 	= limits[j][ZED]; 						// Promote limit %
-
-		// I-term output (throw). Convert from % to actual count
-		// A value of 80,000 results in +/- 1250 or full throw at the output stage
-		// This is because the maximum signal value is +/-1250 after division by 64. 1250 * 64 = 80,000
-		Config.Raw_I_Limits[j][ZED] = temp32 * (int32_t)640;	// 80,000 / 125% = 640
-
-		// I-term source limits. These have to be different due to the I-term gain setting
-		// I-term = (gyro * gain) / 4, so the gyro count for a particular gain and limit is
-		// Gyro = (I-term * 4) / gain :)
-		if (gains[j][ZED] != 0)
-		{
-			gain32 = gains[j][ZED];						// Promote gain value
-			Config.Raw_I_Constrain[j][ZED] = (Config.Raw_I_Limits[j][ZED] << 2) / gain32;
+				Config.Derived.Raw_I_Constrain[j][ZED] = 0;
+			}	
 		}
-		else
-		{
-			Config.Raw_I_Constrain[j][ZED] = 0;
-		}	
 	}
 
 	// Update travel limits
-	for (i = 0; i < MIX_OUTPUTS; i++)
+	if (Config_dirty & (1 << TravelDirty))
 	{
-		Config.Limits[i].minimum = scale_micros(Config.min_travel[i]);
-		Config.Limits[i].maximum = scale_micros(Config.max_travel[i]);
+		for (i = 0; i < MIX_OUTPUTS; i++)
+		{
+			Config.Derived.Limits[i].minimum = scale_micros(Config.min_travel[i]);
+			Config.Derived.Limits[i].maximum = scale_micros(Config.max_travel[i]);
+		}
 	}
 
 	// Adjust trim to match 0.01 degree resolution
 	// A value of 127 multiplied by 100 = 12700 which in 1/100ths of a degree equates to potentially 127 degrees
 	// In reality though, with a more realistic P gain of 10, this equates to potentially 12.7 degrees
-	for (i = P1; i <= P2; i++)
+	if (Config_dirty & (1 << ProfileDirty))
 	{
-		Config.Rolltrim[i] = Config.FlightMode[i].AccRollZeroTrim * 100;
-		Config.Pitchtrim[i] = Config.FlightMode[i].AccPitchZeroTrim * 100;
+		for (i = P1; i <= P2; i++)
+		{
+			Config.Rolltrim[i] = Config.FlightMode[i].AccRollZeroTrim * 100;
+			Config.Pitchtrim[i] = Config.FlightMode[i].AccPitchZeroTrim * 100;
+		}
 	}
 
 	// Additional tasks to ensure compatibility with the GUI
 	// Move any menu post-processing here so that it happens post-reboot
 
 	// Refresh channel order
-	UpdateChOrder();
-
-	// See if mixer preset has changed. The only time it will ever NOT
-	// be "Options" is when the GUI has changed it.
-	if (Config.Preset != OPTIONS)
+	if (Config_dirty & (1 << ChOrderDirty))
 	{
-		Load_eeprom_preset(Config.Preset);
-		
-		// Reset the mixer preset
-		Config.Preset = OPTIONS;
+		UpdateChOrder();
 	}
-	
-	// Update MPU6050 LPF and reverse sense of menu items
-	writeI2Cbyte(MPU60X0_DEFAULT_ADDRESS, MPU60X0_RA_CONFIG, (6 - Config.MPU6050_LPF));
 
-	// Check validity of RX type and PWM speed selection
-	// If illegal setting, drop down to RC Sync
-	if ((Config.RxMode < SBUS) && (Config.Servo_rate == FAST))
+	// Update MPU6050 LPF, sample rate and software LPFs to suit the servo rate
+	if (Config_dirty & (1 << FiltersDirty))
 	{
-		Config.Servo_rate = SYNC;
+		init_i2c_lpf();
 	}
 		
 	// If mode switched to ARMABLE, make sure to disarm	
@@ -959,13 +1025,21 @@ void UpdateLimits(void)
 		LED1 = 0;
 	}	
 
-	// Work out the P1 orientation from the user's P2 orientation setting
-	Config.Orientation_P1 = (int8_t)pgm_read_byte(&P1_Orientation_LUT[Config.Orientation_P2]);
+	if (Config_dirty & (1 << OrientDirty))
+	{
+		// Work out the P1 orientation from the user's P2 orientation setting
+		Config.Orientation_P1 = (int8_t)pgm_read_byte(&P1_Orientation_LUT[Config.Orientation_P2]);
+
+		// Recompile the board orientation and alignment
+		UpdateOrientation();
+	}
+
+	Config_dirty = 0;
 
-	Save_Config_to_EEPROM(); // Save values and return
+	Save_Config_to_EEPROM(); // Save values if changed and return
 }
 
-// Update servos from the mixer Config.Channel[i].P1_value data, add offsets and enforce travel limits
+// Update servos from the mixer Config.Derived.P1_value[i] data, add offsets and enforce travel limits
 void UpdateServos(void)
 {
 	uint8_t i;
@@ -974,7 +1048,7 @@ void UpdateServos(void)
 	for (i = 0; i < MIX_OUTPUTS; i++)
 	{
 		// Servo reverse and trim for the eight physical outputs
-		temp1 = Config.Channel[i].P1_value;
+		temp1 = Config.Derived.P1_value[i];
 
 		// Reverse this channel for the eight physical outputs
 		if ((i <= MIX_OUTPUTS) && (Config.Servo_reverse[i] == ON))
@@ -66,6 +66,7 @@ extern uint8_t buffer[];
 void mugui_text_sizestring(mugui_char_t *s, const unsigned char* font, mugui_size16_t *size);
 void mugui_lcd_puts(mugui_char_t *s, const unsigned char* font,mugui_uint16_t x, mugui_uint16_t y);
 mugui_uint16_t mugui_lcd_putc(mugui_char_t c, const unsigned char* font,mugui_uint16_t x, mugui_uint16_t y);
+mugui_uint16_t mugui_lcd_putc_cols(mugui_char_t c, const unsigned char* font,mugui_uint16_t x, mugui_uint16_t y, mugui_uint8_t first, mugui_uint8_t count);
 void pgm_mugui_lcd_puts(const unsigned char* s, const unsigned char* font,mugui_uint16_t x, mugui_uint16_t y);
 void pgm_mugui_scopy(const char *s);
 
@@ -188,6 +189,23 @@ void mugui_lcd_puts(mugui_char_t *s, const unsigned char* font,mugui_uint16_t x,
 */
 /************************************************************************/
 mugui_uint16_t mugui_lcd_putc(mugui_char_t c, const unsigned char* font,mugui_uint16_t x, mugui_uint16_t y)
+{
+	return mugui_lcd_putc_cols(c, font, x, y, 0, 0xFF);
+}
+
+/*************************************************************************/
+/*! \brief  display some of the columns of a character
+	\param  character c
+	\param  pointer to font
+	\param  x position of the character (upper left corner)
+	\param  y position of the character (upper left corner)
+	\param  first column to draw
+	\param  number of columns to draw
+	\return character width
+	\Created by splitting mugui_lcd_putc(), so a character can be drawn a few columns at a time
+*/
+/************************************************************************/
+mugui_uint16_t mugui_lcd_putc_cols(mugui_char_t c, const unsigned char* font,mugui_uint16_t x, mugui_uint16_t y, mugui_uint8_t first, mugui_uint8_t count)
 {
 	mugui_uint16_t startcharacter = 0; 		//startcharacter of the font
 	mugui_uint16_t height = 0;				//height of the bitmap
@@ -221,8 +239,8 @@ mugui_uint16_t mugui_lcd_putc(mugui_char_t c, const unsigned char* font,mugui_ui
 
 	/* Determine the number of bytes for given width */ 
 	bytes = ((height-1)>>3)+1;
-	/* For every column */
-	for(tx= 0; tx < width; tx++) //for every row
+	/* For every column asked for */
+	for(tx = first; (tx < width) && ((tx - first) < count); tx++)
 	{
 		ty = 0;
 		/* For every byte */
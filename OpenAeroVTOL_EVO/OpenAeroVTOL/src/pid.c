@@ -168,23 +168,13 @@ void Sensor_PID(uint32_t period)
 		// Gyro LPF
 		//************************************************************	
 
-		// Lookup LPF value
-		// Note: Two sets of values for normal and high-speed mode
-		if (Config.Servo_rate != FAST)
-		{
-			memcpy_P(&tempf1, &LPF_lookup[Config.Gyro_LPF], sizeof(float));
-		}
-		else
-		{
-			memcpy_P(&tempf1, &LPF_lookup_HS[Config.Gyro_LPF], sizeof(float));
-		}		
-			
+		// Coefficients come from UpdateFilters()
 		gyroADCf = gyroADC[axis]; // Promote gyro signal to suit
 
-		if (Config.Gyro_LPF != NOFILTER)
+		if (GyroLPF.gain < 1.0f)
 		{
 			// Gyro LPF
-			gyroSmooth[axis] = ((gyroSmooth[axis] * (tempf1 - 1.0f)) + gyroADCf) / tempf1;
+			gyroSmooth[axis] = (gyroSmooth[axis] * GyroLPF.keep) + (gyroADCf * GyroLPF.gain);
 		}
 		else
 		{
@@ -232,14 +222,14 @@ void Sensor_PID(uint32_t period)
 		
 		for (i = P1; i <= P2; i++)
 		{
-			if (IntegralGyro[i][axis] > Config.Raw_I_Constrain[i][axis])
+			if (IntegralGyro[i][axis] > Config.Derived.Raw_I_Constrain[i][axis])
 			{
-				IntegralGyro[i][axis] = Config.Raw_I_Constrain[i][axis];
+				IntegralGyro[i][axis] = Config.Derived.Raw_I_Constrain[i][axis];
 			}
 			
-			if (IntegralGyro[i][axis] < -Config.Raw_I_Constrain[i][axis])
+			if (IntegralGyro[i][axis] < -Config.Derived.Raw_I_Constrain[i][axis])
 			{
-				IntegralGyro[i][axis] = -Config.Raw_I_Constrain[i][axis];
+				IntegralGyro[i][axis] = -Config.Derived.Raw_I_Constrain[i][axis];
 			}
 		}
 
@@ -279,10 +269,10 @@ void Sensor_PID(uint32_t period)
 	tempf1 = period;					// Promote uint32_t to float
 	intervalf = tempf1/25000000.0f;		// This gives the period in 1/10 seconds
 		
-	tempf1 = Config.Raw_I_Constrain[P1][ZED];
+	tempf1 = Config.Derived.Raw_I_Constrain[P1][ZED];
 	tempf1 = tempf1 * intervalf;
 
-	tempf2 = Config.Raw_I_Constrain[P2][ZED];
+	tempf2 = Config.Derived.Raw_I_Constrain[P2][ZED];
 	tempf2 = tempf2 * intervalf;
 
 	if (IntegralAccVertf[P1] > 0)
@@ -321,7 +311,7 @@ void Sensor_PID(uint32_t period)
 	//************************************************************
 	for (i = P1; i <= P2; i++)
 	{
-		tempf1 = Config.Raw_I_Constrain[i][ZED];	// Promote
+		tempf1 = Config.Derived.Raw_I_Constrain[i][ZED];	// Promote
 		
 		if (IntegralAccVertf[i] > tempf1)
 		{
@@ -427,23 +417,23 @@ void Calculate_PID(void)
 		//************************************************************
 
 		// P1 limits
-		if (PID_Gyro_I_actual1 > Config.Raw_I_Limits[P1][axis]) 
+		if (PID_Gyro_I_actual1 > Config.Derived.Raw_I_Limits[P1][axis]) 
 		{
-			PID_Gyro_I_actual1 = Config.Raw_I_Limits[P1][axis];
+			PID_Gyro_I_actual1 = Config.Derived.Raw_I_Limits[P1][axis];
 		}
-		else if (PID_Gyro_I_actual1 < -Config.Raw_I_Limits[P1][axis]) 
+		else if (PID_Gyro_I_actual1 < -Config.Derived.Raw_I_Limits[P1][axis]) 
 		{
-			PID_Gyro_I_actual1 = -Config.Raw_I_Limits[P1][axis];	
+			PID_Gyro_I_actual1 = -Config.Derived.Raw_I_Limits[P1][axis];	
 		}
 
 		// P2 limits
-		if (PID_Gyro_I_actual2 > Config.Raw_I_Limits[P2][axis]) 
+		if (PID_Gyro_I_actual2 > Config.Derived.Raw_I_Limits[P2][axis]) 
 		{
-			PID_Gyro_I_actual2 = Config.Raw_I_Limits[P2][axis];
+			PID_Gyro_I_actual2 = Config.Derived.Raw_I_Limits[P2][axis];
 		}
-		else if (PID_Gyro_I_actual2 < -Config.Raw_I_Limits[P2][axis]) 
+		else if (PID_Gyro_I_actual2 < -Config.Derived.Raw_I_Limits[P2][axis]) 
 		{
-			PID_Gyro_I_actual2 = -Config.Raw_I_Limits[P2][axis];	
+			PID_Gyro_I_actual2 = -Config.Derived.Raw_I_Limits[P2][axis];	
 		}
 
 		//************************************************************
@@ -487,13 +477,13 @@ void Calculate_PID(void)
 		PID_acc_temp2 *= I_gain[i][ZED];					// Multiply I-term (Max gain of 127)
 		PID_acc_temp2 = PID_acc_temp2 >> 2;					// Divide by 4
 
-		if (PID_acc_temp2 > Config.Raw_I_Limits[i][ZED])	// Limit I-term outputs to user-set percentage
+		if (PID_acc_temp2 > Config.Derived.Raw_I_Limits[i][ZED])	// Limit I-term outputs to user-set percentage
 		{
-			PID_acc_temp2 = Config.Raw_I_Limits[i][ZED];
+			PID_acc_temp2 = Config.Derived.Raw_I_Limits[i][ZED];
 		}
-		if (PID_acc_temp2 < -Config.Raw_I_Limits[i][ZED])
+		if (PID_acc_temp2 < -Config.Derived.Raw_I_Limits[i][ZED])
 		{
-			PID_acc_temp2 = -Config.Raw_I_Limits[i][ZED];
+			PID_acc_temp2 = -Config.Derived.Raw_I_Limits[i][ZED];
 		}
 
 		// Formulate PI value and scale
@@ -20,12 +20,14 @@
 #include "main.h"
 #include "eeprom.h"
 #include "mixer.h"
+#include "compiledefs.h"
 
 //************************************************************
 // Prototypes
 //************************************************************
 
 void RxGetChannels(void);
+void RxInterpolate(void);
 void RC_Deadband(void);
 void CenterSticks(void);
 void UpdateTransition(void);
@@ -35,6 +37,8 @@ void UpdateTransition(void);
 //************************************************************
 
 #define	NOISE_THRESH	5			// Max RX noise threshold
+#define RC_SMOOTH_CHANNELS 4		// Interpolate THROTTLE, AILERON, ELEVATOR and RUDDER only
+#define RC_SMOOTH_MAX	586			// Longest frame period that is interpolated. 586 * 1/19531 = 30ms
 
 //************************************************************
 // Code
@@ -43,6 +47,10 @@ void UpdateTransition(void);
 volatile int16_t RCinputs[MAX_RC_CHANNELS + 1];						// Normalised RC inputs
 volatile int16_t MonopolarThrottle;									// Monopolar throttle
 
+uint16_t RxChannelSmooth[MAX_RC_CHANNELS];							// Interpolated RC channel data
+uint16_t RxFrameStart[RC_SMOOTH_CHANNELS];							// Interpolation start point
+uint16_t RxFrameTarget[RC_SMOOTH_CHANNELS];							// Interpolation end point (latest RC frame)
+
 // Get raw flight channel data (~2500 to 5000) and remove zero offset
 // Use channel mapping for reconfigurability
 void RxGetChannels(void)
@@ -51,19 +59,22 @@ void RxGetChannels(void)
 	int16_t	RxSumDiff;
 	int16_t	RxSum, i;
 
+	// Smooth out the steps between RC frames
+	RxInterpolate();
+
 	// Remove zero offsets
 	for (i=0; i < MAX_RC_CHANNELS; i++)
 	{
-		RCinputs[i]	= RxChannel[i] - Config.RxChannelZeroOffset[i];
+		RCinputs[i]	= RxChannelSmooth[i] - Config.RxChannelZeroOffset[i];
 	}
 
 	// Special handling for monopolar throttle
 	// Preset to RxChannelZeroOffset[THROTTLE] = 2750 (-250 to 2250) for safety. 
 	// Normally MonopolarThrottle is referenced to the lowest throttle position.
-	MonopolarThrottle = RxChannel[THROTTLE] - Config.RxChannelZeroOffset[THROTTLE]; 
+	MonopolarThrottle = RxChannelSmooth[THROTTLE] - Config.RxChannelZeroOffset[THROTTLE]; 
 
 	// Bipolar throttle must use the nominal mid-point as calibration is done at throttle minimum
-	RCinputs[THROTTLE] = RxChannel[THROTTLE] - 3750; 
+	RCinputs[THROTTLE] = RxChannelSmooth[THROTTLE] - 3750; 
 
 	// Reverse primary channels as requested
 	if (Config.AileronPol == REVERSED)
@@ -101,6 +112,102 @@ void RxGetChannels(void)
 	OldRxSum = RxSum;
 }
 
+// Count new RC frames and, if RC_INTERPOLATE is defined, interpolate 
+// the primary RC channels at loop rate.
+// Each new value becomes the target, which is reached one measured
+// update period later. Each channel is timed separately as 11ms Spektrum
+// frames may only carry some of them. Switch channels are passed through untouched.
+void RxInterpolate(void)
+{
+#ifdef RC_INTERPOLATE
+	static uint16_t Frame_timer[RC_SMOOTH_CHANNELS] = {RC_SMOOTH_MAX + 1, RC_SMOOTH_MAX + 1, RC_SMOOTH_MAX + 1, RC_SMOOTH_MAX + 1}; // T2 ticks since each channel was updated. No ramp for the first frame
+	static uint16_t Frame_period[RC_SMOOTH_CHANNELS];	// Measured update period of each channel in T2 ticks
+	static uint8_t	Frame_TCNT2 = 0;
+	uint16_t frac;
+	int16_t	delta;
+	uint8_t elapsed;
+	uint8_t fresh = 0;
+#endif
+	uint8_t sreg;
+	uint8_t i;
+
+#ifdef RC_INTERPOLATE
+	// Time since the last call. TCNT2 increments at 19.531kHz.
+	elapsed = (uint8_t)(TCNT2 - Frame_TCNT2);
+	Frame_TCNT2 = TCNT2;
+#endif
+
+	// New RC frame. Find out which channels it carried.
+	if (RxFrameReady)
+	{
+		sreg = SREG;
+		cli();
+		RxFrameReady = false;
+#ifdef RC_INTERPOLATE
+		fresh = RxChannelFresh;
+#endif
+		RxChannelFresh = 0;
+		SREG = sreg;
+
+		RxStats.frames++;
+
+#ifdef RC_INTERPOLATE
+		// Only Spektrum splits channels across frames
+		if (Config.RxMode != SPEKTRUM)
+		{
+			fresh = 0xFF;
+		}
+#endif
+	}
+
+#ifdef RC_INTERPOLATE
+	for (i = 0; i < RC_SMOOTH_CHANNELS; i++)
+	{
+		// Limit to just over RC_SMOOTH_MAX so that the timer can't wrap.
+		Frame_timer[i] += elapsed;
+
+		if (Frame_timer[i] > RC_SMOOTH_MAX)
+		{
+			Frame_timer[i] = RC_SMOOTH_MAX + 1;
+		}
+
+		// Fresh data for this channel. Start a new ramp from where we are now.
+		if (fresh & (1 << i))
+		{
+			Frame_period[i] = Frame_timer[i];
+			Frame_timer[i] = 0;
+			RxFrameStart[i] = RxChannelSmooth[i];
+			RxFrameTarget[i] = RxChannel[i];
+		}
+
+		// Ramp complete, or the update period is too long to interpolate across
+		if ((Frame_timer[i] >= Frame_period[i]) || (Frame_period[i] > RC_SMOOTH_MAX))
+		{
+			RxChannelSmooth[i] = RxChannel[i];
+		}
+		else
+		{
+			// Elapsed fraction of the update period in 1/256ths
+			frac = ((uint32_t)Frame_timer[i] << 8) / Frame_period[i];
+			delta = RxFrameTarget[i] - RxFrameStart[i];
+			RxChannelSmooth[i] = RxFrameStart[i] + (int16_t)(((int32_t)delta * frac) >> 8);
+		}
+	}
+
+	// Pass the remaining channels through
+	for (i = RC_SMOOTH_CHANNELS; i < MAX_RC_CHANNELS; i++)
+	{
+		RxChannelSmooth[i] = RxChannel[i];
+	}
+#else
+	// Pass all channels straight through, so that nothing is delayed
+	for (i = 0; i < MAX_RC_CHANNELS; i++)
+	{
+		RxChannelSmooth[i] = RxChannel[i];
+	}
+#endif
+}
+
 // Center sticks on request from Menu
 void CenterSticks(void)		
 {
@@ -146,30 +253,30 @@ void UpdateTransition(void)
 }
 
 // Update channel order
-void UpdateChOrder(void)
-{
-	uint8_t i;
-	
+void UpdateChOrder(void)
+{
+	uint8_t i;
+	
 	// Populate each channel number with the correct lookup channel
 	for (i = 0; i < MAX_RC_CHANNELS; i++)
 	{
 		// Update channel sequence
 		if (Config.TxSeq == FUTABASEQ)
 		{
-			Config.ChannelOrder[i] = pgm_read_byte(&FUTABA[i]);
+			Config.Derived.ChannelOrder[i] = pgm_read_byte(&FUTABA[i]);
 		}
 		else if (Config.TxSeq == JRSEQ)
 		{
-			Config.ChannelOrder[i] = pgm_read_byte(&JR[i]);
+			Config.Derived.ChannelOrder[i] = pgm_read_byte(&JR[i]);
 		}
 		else if (Config.TxSeq == MPXSEQ)
 		{
-			Config.ChannelOrder[i] = pgm_read_byte(&MPX[i]);
+			Config.Derived.ChannelOrder[i] = pgm_read_byte(&MPX[i]);
 		}
 		// Otherwise load from custom channel order
 		else
 		{
-			Config.ChannelOrder[i] = Config.CustomChannelOrder[i];
+			Config.Derived.ChannelOrder[i] = Config.CustomChannelOrder[i];
 		}
 	}
 }
\ No newline at end of file
@@ -52,14 +52,14 @@ void output_servo_ppm(uint8_t ServoFlag)
 		}
 		
 		// Enforce min, max travel limits in microseconds
-		if (temp > Config.Limits[i].maximum)
+		if (temp > Config.Derived.Limits[i].maximum)
 		{
-			temp = Config.Limits[i].maximum;
+			temp = Config.Derived.Limits[i].maximum;
 		}
 
-		else if (temp < Config.Limits[i].minimum)
+		else if (temp < Config.Derived.Limits[i].minimum)
 		{
-			temp = Config.Limits[i].minimum;
+			temp = Config.Derived.Limits[i].minimum;
 		}
 
 		ServoOut[i] = (uint16_t)temp;
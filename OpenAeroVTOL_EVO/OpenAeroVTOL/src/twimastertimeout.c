@@ -18,6 +18,7 @@
 #include "compiledefs.h"
 #include <inttypes.h>
 #include <compat/twi.h>
+#include <util/delay.h>
 
 /* define CPU frequency in MHz here if not defined in Makefile */
 #ifndef F_CPU
@@ -30,6 +31,16 @@
 /* I2C timer max delay */
 #define I2C_TIMER_DELAY 0xFF
 
+/* Number of times i2c_start_wait() retries a busy device */
+#define I2C_START_RETRIES 4
+
+/* TWI pins, used directly for bus recovery */
+#define I2C_SCL PC0
+#define I2C_SDA PC1
+
+/* Set when any operation fails or times out. Cleared by the caller. */
+unsigned char i2c_error;
+
 /*************************************************************************
  Initialization of the I2C bus interface. Need to be called only once
 *************************************************************************/
@@ -58,12 +69,19 @@ unsigned char i2c_start(unsigned char address)
 	// wait until transmission completed
 	i2c_timer = I2C_TIMER_DELAY;
 	while(!(TWCR & (1<<TWINT)) && i2c_timer--);
-	if(i2c_timer == 0)
+	if(!(TWCR & (1<<TWINT)))
+	{
+		i2c_error = 1;
 		return 1;
+	}
 
 	// check value of TWI Status Register. Mask prescaler bits.
 	twst = TW_STATUS & 0xF8;
-	if ( (twst != TW_START) && (twst != TW_REP_START)) return 1;
+	if ( (twst != TW_START) && (twst != TW_REP_START))
+	{
+		i2c_error = 1;
+		return 1;
+	}
 
 	// send device address
 	TWDR = address;
@@ -72,12 +90,19 @@ unsigned char i2c_start(unsigned char address)
 	// wail until transmission completed and ACK/NACK has been received
 	i2c_timer = I2C_TIMER_DELAY;
 	while(!(TWCR & (1<<TWINT)) && i2c_timer--);
-	if(i2c_timer == 0)
+	if(!(TWCR & (1<<TWINT)))
+	{
+		i2c_error = 1;
 		return 1;
+	}
 
 	// check value of TWI Status Register. Mask prescaler bits.
 	twst = TW_STATUS & 0xF8;
-	if ( (twst != TW_MT_SLA_ACK) && (twst != TW_MR_SLA_ACK) ) return 1;
+	if ( (twst != TW_MT_SLA_ACK) && (twst != TW_MR_SLA_ACK) )
+	{
+		i2c_error = 1;
+		return 1;
+	}
 
 	return 0;
 
@@ -86,16 +111,21 @@ unsigned char i2c_start(unsigned char address)
 
 /*************************************************************************
  Issues a start condition and sends address and transfer direction.
- If device is busy, use ack polling to wait until device is ready
+ If device is busy, use ack polling to wait until device is ready.
+ Gives up after I2C_START_RETRIES attempts so that a dead or stuck
+ bus can't hang the caller.
  
  Input:   address and transfer direction of I2C device
+ Return:  0 device accessible
+          1 failed to access device
 *************************************************************************/
-void i2c_start_wait(unsigned char address)
+unsigned char i2c_start_wait(unsigned char address)
 {
 	uint32_t  i2c_timer = 0;
 	uint8_t   twst;
+	uint8_t   retries;
 
-    while ( 1 )
+    for (retries = 0; retries < I2C_START_RETRIES; retries++)
     {
 	    // send START condition
 	    TWCR = (1<<TWINT) | (1<<TWSTA) | (1<<TWEN);
@@ -129,10 +159,13 @@ void i2c_start_wait(unsigned char address)
 	        
     	    continue;
     	}
-    	//if( twst != TW_MT_SLA_ACK) return 1;
-    	break;
+    	
+    	if ( (twst == TW_MT_SLA_ACK) || (twst == TW_MR_SLA_ACK) ) return 0;
      }
 
+	i2c_error = 1;
+	return 1;
+
 }/* i2c_start_wait */
 
 
@@ -187,12 +220,19 @@ unsigned char i2c_write( unsigned char data )
 	// wait until transmission completed
 	i2c_timer = I2C_TIMER_DELAY;
 	while(!(TWCR & (1<<TWINT)) && i2c_timer--);
-	if(i2c_timer == 0)
+	if(!(TWCR & (1<<TWINT)))
+	{
+		i2c_error = 1;
 		return 1;
+	}
 
 	// check value of TWI Status Register. Mask prescaler bits
 	twst = TW_STATUS & 0xF8;
-	if( twst != TW_MT_DATA_ACK) return 1;
+	if( twst != TW_MT_DATA_ACK)
+	{
+		i2c_error = 1;
+		return 1;
+	}
 	return 0;
 
 }/* i2c_write */
@@ -210,8 +250,11 @@ unsigned char i2c_readAck(void)
 	TWCR = (1<<TWINT) | (1<<TWEN) | (1<<TWEA);
 	i2c_timer = I2C_TIMER_DELAY;
 	while(!(TWCR & (1<<TWINT)) && i2c_timer--);
-	if(i2c_timer == 0)
+	if(!(TWCR & (1<<TWINT)))
+	{
+		i2c_error = 1;
 		return 0;
+	}
 
     return TWDR;
 
@@ -230,10 +273,54 @@ unsigned char i2c_readNak(void)
 	TWCR = (1<<TWINT) | (1<<TWEN);
 	i2c_timer = I2C_TIMER_DELAY;
 	while(!(TWCR & (1<<TWINT)) && i2c_timer--);
-	if(i2c_timer == 0)
+	if(!(TWCR & (1<<TWINT)))
+	{
+		i2c_error = 1;
 		return 0;
+	}
 	
     return TWDR;
 
 }/* i2c_readNak */
 
+
+/*************************************************************************
+ Recover a stuck bus. A slave that was interrupted mid-byte can hold
+ SDA low indefinitely. Clock SCL by hand until the slave lets go of
+ SDA (at most 9 clocks), send a STOP, then restart the TWI.
+ Takes about 100us. Pins are driven open-drain by switching DDRC.
+*************************************************************************/
+void i2c_recover(void)
+{
+	uint8_t i;
+
+	// Release the pins from the TWI
+	TWCR = 0;
+	PORTC &= ~((1<<I2C_SCL) | (1<<I2C_SDA));
+	DDRC &= ~((1<<I2C_SCL) | (1<<I2C_SDA));
+	_delay_us(5);
+
+	// Clock out whatever the slave is trying to send
+	for (i = 0; (i < 9) && !(PINC & (1<<I2C_SDA)); i++)
+	{
+		DDRC |= (1<<I2C_SCL);				// SCL low
+		_delay_us(5);
+		DDRC &= ~(1<<I2C_SCL);				// SCL high
+		_delay_us(5);
+	}
+
+	// STOP: SDA rises while SCL is high
+	DDRC |= (1<<I2C_SCL);
+	DDRC |= (1<<I2C_SDA);
+	_delay_us(5);
+	DDRC &= ~(1<<I2C_SCL);
+	_delay_us(5);
+	DDRC &= ~(1<<I2C_SDA);
+	_delay_us(5);
+
+	// Restart the TWI
+	i2c_init();
+	TWCR = (1<<TWEN);
+
+}/* i2c_recover */
+
@@ -8,16 +8,21 @@
 
 #include <avr/interrupt.h>
 #include <avr/io.h>
+#include <avr/pgmspace.h>
 #include <stdbool.h>
 #include <stdlib.h>
 #include <util/delay.h>
 #include "io_cfg.h"
+#include "isr.h"
+#include "uart.h"
 
 //************************************************************
 // Prototypes
 //************************************************************
 
 void init_uart(void);
+uint16_t CRC16(uint16_t crc, uint8_t value);
+uint8_t CRC8_DVB_S2(uint8_t crc, uint8_t value);
 
 //************************************************************
 // Code
@@ -35,7 +40,45 @@ void init_uart(void);
 #define USART_BAUDRATE_SPEKTRUM 115200
 #define BAUD_PRESCALE_SPEKTRUM ((F_CPU + USART_BAUDRATE_SPEKTRUM * 8L) / (USART_BAUDRATE_SPEKTRUM * 16L) - 1) // Default RX rate for Spektrum
 
-#define XBUS_CRC_POLY 0x1021
+#define USART_BAUDRATE_CRSF 420000
+#define BAUD_PRESCALE_CRSF ((F_CPU + USART_BAUDRATE_CRSF * 4L) / (USART_BAUDRATE_CRSF * 8L) - 1) // Default RX rate for CRSF
+
+// Frame formats
+#define UART_8N1 ((1 << UCSZ01) | (1 << UCSZ00))
+#define UART_8E2 ((1 << UPM01) | (1 << USBS0) | (1 << UCSZ01) | (1 << UCSZ00))
+
+#define CRSF_CRC_POLY 0xD5
+
+#define IBUS_SYNCBYTE 0x20					// IBUS frame length byte
+#define CRSF_SYNCBYTE 0xC8					// CRSF flight controller address
+
+//************************************************************
+// Serial RX protocol table
+// One entry per serial RX mode, in RX_Modes order from SBUS.
+// Adding a protocol only needs a new entry here and its decoder in isr.c
+//************************************************************
+
+const serial_rx_t serial_rx_table[] PROGMEM = 
+{
+	// Baud divisor, UCSR0A, UCSR0C, Sync byte, Decoder
+	{BAUD_PRESCALE_SBUS,		(1 << U2X0), UART_8E2,	0,				Decode_SBus},		// Futaba S-Bus 8E2 (8 data bits / Even parity / 2 stop bits / 100Kbps)
+	{BAUD_PRESCALE_SPEKTRUM,	0,			 UART_8N1,	0,				Decode_Spektrum},	// Spektrum 8N1 (8 data bits / No parity / 1 stop bit / 115.2Kbps)
+	{BAUD_PRESCALE_XTREME,		0,			 UART_8N1,	0,				Decode_Xtreme},		// Xtreme 8N1 (8 data bits / No parity / 1 stop bit / 250Kbps)
+	{BAUD_PRESCALE_SPEKTRUM,	0,			 UART_8N1,	0,				Decode_ModeB},		// Mode B/UDI 8N1 (115.2Kbps)
+	{BAUD_PRESCALE_SPEKTRUM,	0,			 UART_8N1,	0,				Decode_SUMD},		// HoTT SUMD 8N1 (115.2Kbps)
+	{BAUD_PRESCALE_SPEKTRUM,	0,			 UART_8N1,	IBUS_SYNCBYTE,	Decode_IBus},		// FlySky IBUS 8N1 (115.2Kbps)
+	{BAUD_PRESCALE_CRSF,		(1 << U2X0), UART_8N1,	CRSF_SYNCBYTE,	Decode_CRSF},		// CRSF 8N1 (8 data bits / No parity / 1 stop bit / 420Kbps)
+};
+
+// Descriptor for the current serial RX mode
+serial_rx_t SerialRX;
+
+// CRC-CCITT (polynomial 0x1021) of each nibble, for CRC16()
+const uint16_t CRC16_table[16] PROGMEM = 
+{
+	0x0000, 0x1021, 0x2042, 0x3063, 0x4084, 0x50A5, 0x60C6, 0x70E7,
+	0x8108, 0x9129, 0xA14A, 0xB16B, 0xC18C, 0xD1AD, 0xE1CE, 0xF1EF
+};
 
 // Initialise UART with adjusted bitrate
 void init_uart(void)
@@ -54,70 +97,59 @@ void init_uart(void)
 	UCSR0B = 0; // Clear flags, disable tx/rx, 8 bits
 	UCSR0C = 6; // 8N1
 
-	switch (Config.RxMode)
+	// Set up the UART from the protocol table for serial modes
+	// Xtreme:		Actual = 250000, Error = 0%
+	// S-Bus:		Actual = 100000, Error = 0%
+	// Spektrum:	Actual = 113636, Error = -1.36% (Same for MODEB/UDI, SUMD, IBUS)
+	// CRSF:		Actual = 416667, Error = -0.79%
+	if ((Config.RxMode >= SBUS) && (Config.RxMode <= CRSF))
+	{
+		memcpy_P(&SerialRX, &serial_rx_table[Config.RxMode - SBUS], sizeof(serial_rx_t));
+		
+		UCSR0A  =  SerialRX.ucsra;						// Set or clear the 2x flag
+		UBRR0H  = (SerialRX.baud >> 8);
+		UBRR0L  =  SerialRX.baud & 0xff;
+		UCSR0C  =  SerialRX.ucsrc;						// Parity, stop bits and data bits
+		UCSR0B |=  (1 << RXEN0);						// Enable receiver
+		UCSR0B |=  (1 << RXCIE0);						// Enable serial interrupt
+
+		// Detect the Spektrum format afresh. This is not done in init_int() as FAST
+		// servo mode re-enables the RC interrupts through it after every frame.
+		SpektrumFormat = 0;
+		SpektrumGuess = 0;
+		SpektrumMask10 = 0;
+		SpektrumMask11 = 0;
+	}
+	else
 	{
-		// Xtreme 8N1 (8 data bits / No parity / 1 stop bit / 250Kbps)
-		case XTREME:
-			UCSR0A &= ~(1 << U2X0);						// Clear the 2x flag
-			UBRR0H  = (BAUD_PRESCALE_XTREME >> 8); 		// Actual = 250000, Error = 0%
-			UBRR0L  =  BAUD_PRESCALE_XTREME & 0xff;		// 0x04
-			UCSR0B |=  (1 << RXEN0);					// Enable receiver
-			UCSR0C &= ~(1 << USBS0); 					// 1 stop bit
-			UCSR0C &=  ~(1 << UPM00) | 					// No parity
-						(1 << UPM01);
-			UCSR0B |=  (1 << RXCIE0);					// Enable serial interrupt
-			break;
-				
-		// Futaba S-Bus 8E2 (8 data bits / Even parity / 2 stop bits / 100Kbps)
-		case SBUS: 		
-			UCSR0A |=  (1 << U2X0);						// Need to set the 2x flag
-			UBRR0H  = (BAUD_PRESCALE_SBUS >> 8);  		// Actual = 100000 , Error = 0%	
-			UBRR0L  =  BAUD_PRESCALE_SBUS & 0xff;		// 0x18 (24)
-			UCSR0B |=  (1 << RXEN0);					// Enable receiver
-			UCSR0C |=  (1 << USBS0); 					// 2 stop bits
-			UCSR0C &= ~(1 << UPM00); 					// Even parity 
-			UCSR0C |=  (1 << UPM01); 
-			UCSR0B |=  (1 << RXCIE0);					// Enable serial interrupt
-			break;
-
-		// Spektrum 8N1 (8 data bits / No parity / 1 stop bit / 115.2Kbps) (Same for MODEB/UDI, SUMD)
-		case SUMD:
-		case MODEB:
-		case SPEKTRUM: 	
-			UCSR0A &=  ~(1 << U2X0);					// Clear the 2x flag
-			UBRR0H  =  (BAUD_PRESCALE_SPEKTRUM >> 8); 	// Actual = 113636, Error = -1.36%
-			UBRR0L  =   BAUD_PRESCALE_SPEKTRUM & 0xff;	// 0x0A (10.35)	
-			UCSR0B |= 	(1 << RXEN0);					// Enable receiver
-			UCSR0C &=  ~(1 << USBS0); 					// 1 stop bit
-			UCSR0C &=  ~(1 << UPM00) | 					// No parity 
-						(1 << UPM01); 
-			UCSR0B |=  (1 << RXCIE0);					// Enable serial interrupt
-			break;
-
-		case CPPM_MODE:
-		case PWM:
-			UCSR0B &= 	~(1 << RXEN0);					// Disable receiver in PWM and CPPM modes
-
-		default:
-			break;
+		UCSR0B &= 	~(1 << RXEN0);						// Disable receiver in PWM and CPPM modes
 	}
 
 	// Re-enable interrupts
 	sei();
 }
 
-// CRC16 checksum
+// CRC16 checksum (CRC-CCITT), a nibble at a time from CRC16_table
 uint16_t CRC16(uint16_t crc, uint8_t value)
+{
+	crc = (crc << 4) ^ pgm_read_word(&CRC16_table[(crc >> 12) ^ (value >> 4)]);
+	crc = (crc << 4) ^ pgm_read_word(&CRC16_table[(crc >> 12) ^ (value & 0x0F)]);
+
+	return crc;
+}
+
+// CRC8 checksum (DVB-S2) as used by CRSF
+uint8_t CRC8_DVB_S2(uint8_t crc, uint8_t value)
 {
 	uint8_t i;
 	
-	crc = crc ^ (uint16_t)value << 8;
+	crc = crc ^ value;
 	
 	for (i = 0; i < 8; i++)
 	{
-		if (crc & 0x8000)
+		if (crc & 0x80)
 		{
-			crc = crc << 1 ^XBUS_CRC_POLY;
+			crc = crc << 1 ^ CRSF_CRC_POLY;
 		}
 		else
 		{
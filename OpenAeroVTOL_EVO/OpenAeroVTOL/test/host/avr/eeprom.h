@@ -0,0 +1,21 @@
+//***********************************************************
+//* avr/eeprom.h
+//*
+//* Host stand-in for the avr-libc eeprom functions. Writes
+//* complete at once, so the eeprom is never busy.
+//***********************************************************
+
+#ifndef HOST_AVR_EEPROM_H
+#define HOST_AVR_EEPROM_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+uint8_t eeprom_read_byte(const uint8_t* addr);
+uint16_t eeprom_read_word(const uint16_t* addr);
+void eeprom_read_block(void* dst, const void* src, size_t n);
+void eeprom_write_byte(uint8_t* addr, uint8_t value);
+
+#define eeprom_busy_wait()
+
+#endif
@@ -0,0 +1,18 @@
+//***********************************************************
+//* avr/interrupt.h
+//*
+//* Host stand-in. The interrupt flag is just the I bit in SREG,
+//* and an ISR is an ordinary function the tests call.
+//***********************************************************
+
+#ifndef HOST_AVR_INTERRUPT_H
+#define HOST_AVR_INTERRUPT_H
+
+#include <avr/io.h>
+
+#define ISR(vector, ...) void vector(void)
+
+#define cli() (SREG &= (uint8_t)~(1 << SREG_I))
+#define sei() (SREG |= (1 << SREG_I))
+
+#endif
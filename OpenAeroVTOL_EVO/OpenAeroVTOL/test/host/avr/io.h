@@ -0,0 +1,31 @@
+//***********************************************************
+//* avr/io.h
+//*
+//* Host stand-in for the ATmega644P registers used by the
+//* code under test. The eeprom registers are backed by the
+//* simulated eeprom in host_eeprom.c.
+//***********************************************************
+
+#ifndef HOST_AVR_IO_H
+#define HOST_AVR_IO_H
+
+#include <stdint.h>
+
+extern volatile uint8_t SREG;
+extern volatile uint8_t EECR;
+extern volatile uint16_t EEAR;
+
+// Reading EEDR after setting EERE returns the eeprom byte at EEAR
+extern volatile uint8_t* host_eedr(void);
+#define EEDR (*host_eedr())
+
+#define SREG_I	7
+
+#define EERE	0
+#define EEPE	1
+#define EEMPE	2
+#define EERIE	3
+
+#define E2END	0x7FF
+
+#endif
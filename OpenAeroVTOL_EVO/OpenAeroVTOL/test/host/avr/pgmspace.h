@@ -0,0 +1,19 @@
+//***********************************************************
+//* avr/pgmspace.h
+//*
+//* Host stand-in. Flash data is ordinary memory.
+//***********************************************************
+
+#ifndef HOST_AVR_PGMSPACE_H
+#define HOST_AVR_PGMSPACE_H
+
+#include <stdint.h>
+#include <string.h>
+
+#define PROGMEM
+
+#define pgm_read_byte(addr) (*(const uint8_t*)(addr))
+#define pgm_read_word(addr) (*(const uint16_t*)(addr))
+#define memcpy_P memcpy
+
+#endif
@@ -0,0 +1,129 @@
+//***********************************************************
+//* host_eeprom.c
+//*
+//* Simulated eeprom and registers for running eeprom.c on
+//* the host. Byte writes started from the EE_READY interrupt
+//* only land when host_eeprom_run() completes them, so a test
+//* can cut the power part way through a background save.
+//***********************************************************
+
+//***********************************************************
+//* Includes
+//***********************************************************
+
+#include <string.h>
+#include <stdbool.h>
+#include <avr/io.h>
+#include <avr/eeprom.h>
+#include <avr/pgmspace.h>
+#include "io_cfg.h"
+#include "eeprom.h"
+#include "host_eeprom.h"
+
+//************************************************************
+// Prototypes
+//************************************************************
+
+void EE_READY_vect(void);
+uint16_t CRC16(uint16_t crc, uint8_t value);
+
+//************************************************************
+// Code
+//************************************************************
+
+CONFIG_STRUCT Config;
+
+uint8_t ee[E2END + 1];				// Eeprom contents
+uint16_t host_eeprom_writes = 0;	// Bytes programmed since the test last cleared it
+
+volatile uint8_t SREG;
+volatile uint8_t EECR;
+volatile uint16_t EEAR;
+volatile uint8_t EEDR_latch;
+
+volatile uint8_t* host_eedr(void)
+{
+	if (EECR & (1 << EERE))
+	{
+		EECR &= ~(1 << EERE);
+		EEDR_latch = ee[EEAR];
+	}
+
+	return &EEDR_latch;
+}
+
+uint8_t eeprom_read_byte(const uint8_t* addr)
+{
+	return ee[(uintptr_t)addr];
+}
+
+uint16_t eeprom_read_word(const uint16_t* addr)
+{
+	uintptr_t a = (uintptr_t)addr;
+
+	return (ee[a] | (ee[a + 1] << 8));
+}
+
+void eeprom_read_block(void* dst, const void* src, size_t n)
+{
+	memcpy(dst, &ee[(uintptr_t)src], n);
+}
+
+void eeprom_write_byte(uint8_t* addr, uint8_t value)
+{
+	ee[(uintptr_t)addr] = value;
+	host_eeprom_writes++;
+}
+
+// Let the EE_READY interrupt run until it has nothing left to do.
+// The power is cut just before byte number "cut" is programmed,
+// which leaves that byte as it was. Returns false if cut.
+bool host_eeprom_run(uint16_t cut)
+{
+	uint16_t written = 0;
+
+	while (EECR & (1 << EERIE))
+	{
+		EE_READY_vect();
+
+		if (EECR & (1 << EEPE))
+		{
+			if (written == cut)
+			{
+				return false;
+			}
+
+			ee[EEAR] = EEDR_latch;
+			EECR &= ~(1 << EEPE);
+			written++;
+			host_eeprom_writes++;
+		}
+	}
+
+	return true;
+}
+
+// Power up again with whatever is in the eeprom and junk in RAM.
+// Interrupts are off, as they are when init() loads the settings.
+void host_reboot(void)
+{
+	SREG = 0;
+	EECR = 0;
+	EEPROM_save_pending = false;
+	memset(&Config, 0x5A, sizeof(Config));
+}
+
+// Same as uart.c
+const uint16_t CRC16_table[16] PROGMEM =
+{
+	0x0000, 0x1021, 0x2042, 0x3063, 0x4084, 0x50A5, 0x60C6, 0x70E7,
+	0x8108, 0x9129, 0xA14A, 0xB16B, 0xC18C, 0xD1AD, 0xE1CE, 0xF1EF
+};
+
+uint16_t CRC16(uint16_t crc, uint8_t value)
+{
+	crc = (crc << 4) ^ pgm_read_word(&CRC16_table[(crc >> 12) ^ (value >> 4)]);
+	crc = (crc << 4) ^ pgm_read_word(&CRC16_table[(crc >> 12) ^ (value & 0x0F)]);
+
+	return crc;
+}
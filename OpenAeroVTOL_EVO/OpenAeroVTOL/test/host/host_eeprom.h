@@ -0,0 +1,20 @@
+//***********************************************************
+//* host_eeprom.h
+//***********************************************************
+
+#ifndef HOST_EEPROM_H
+#define HOST_EEPROM_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <avr/io.h>
+
+#define HOST_NO_CUT 0xFFFF			// host_eeprom_run() runs the save to the end
+
+extern uint8_t ee[E2END + 1];
+extern uint16_t host_eeprom_writes;
+
+extern bool host_eeprom_run(uint16_t cut);
+extern void host_reboot(void);
+
+#endif
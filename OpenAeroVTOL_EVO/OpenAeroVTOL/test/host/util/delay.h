@@ -0,0 +1,13 @@
+//***********************************************************
+//* util/delay.h
+//*
+//* Host stand-in. Delays take no time.
+//***********************************************************
+
+#ifndef HOST_UTIL_DELAY_H
+#define HOST_UTIL_DELAY_H
+
+#define _delay_ms(ms)
+#define _delay_us(us)
+
+#endif
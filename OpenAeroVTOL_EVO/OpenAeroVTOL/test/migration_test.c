@@ -0,0 +1,156 @@
+//***********************************************************
+//* migration_test.c
+//*
+//* Round-trips each historical eeprom layout through the
+//* start-up upgrade. Each fixture holds an eeprom image as
+//* left by an old version and the settings it must upgrade
+//* to. The image is loaded, checked against the expected
+//* settings, then loaded again from the bank the upgrade
+//* saved, which must give the same settings without another
+//* upgrade.
+//*
+//* Usage: migration_test fixtures/*.hex
+//***********************************************************
+
+//***********************************************************
+//* Includes
+//***********************************************************
+
+#include <stdio.h>
+#include <string.h>
+#include <stdbool.h>
+#include <avr/io.h>
+#include "io_cfg.h"
+#include "eeprom.h"
+#include "host_eeprom.h"
+
+//************************************************************
+// Defines
+//************************************************************
+
+#define CONFIG_SAVED_SIZE (sizeof(CONFIG_STRUCT) - sizeof(Config.Upgrade))
+#define IMAGE_SIZE sizeof(CONFIG_STRUCT)	// Old layouts are read from bank A, up to the full struct
+
+//************************************************************
+// Code
+//************************************************************
+
+uint8_t image[IMAGE_SIZE];
+uint8_t settings[CONFIG_SAVED_SIZE];
+
+// Read "count" hex bytes that follow the line "section"
+bool read_section(FILE* f, const char* section, uint8_t* data, uint16_t count)
+{
+	char	line[128];
+	unsigned value;
+	uint16_t i = 0;
+
+	rewind(f);
+
+	while (fgets(line, sizeof(line), f))
+	{
+		if (!strncmp(line, section, strlen(section)))
+		{
+			while ((i < count) && (fscanf(f, " %x", &value) == 1))
+			{
+				data[i++] = (uint8_t)value;
+			}
+
+			break;
+		}
+	}
+
+	return (i == count);
+}
+
+// Print the first few differences from the expected settings
+void show_diffs(void)
+{
+	uint8_t	*ram = (uint8_t*)&Config;
+	uint16_t i;
+	uint8_t	shown = 0;
+
+	for (i = 0; (i < CONFIG_SAVED_SIZE) && (shown < 8); i++)
+	{
+		if (ram[i] != settings[i])
+		{
+			printf("    byte %u is 0x%02X, expected 0x%02X\n", i, ram[i], settings[i]);
+			shown++;
+		}
+	}
+}
+
+bool test_fixture(const char* name)
+{
+	FILE	*f = fopen(name, "r");
+	bool	ok;
+
+	if (!f)
+	{
+		printf("%s: can't open\n", name);
+		return false;
+	}
+
+	ok = read_section(f, "image", image, IMAGE_SIZE) && read_section(f, "settings", settings, CONFIG_SAVED_SIZE);
+	fclose(f);
+
+	if (!ok)
+	{
+		printf("%s: bad fixture\n", name);
+		return false;
+	}
+
+	// Power up with the old layout in bank A and the rest of the eeprom erased
+	memset(ee, 0xFF, sizeof(ee));
+	memcpy(ee, image, IMAGE_SIZE);
+	host_reboot();
+
+	if (!Initial_EEPROM_Config_Load())
+	{
+		printf("%s: layout 0x%02X was not upgraded\n", name, image[0]);
+		return false;
+	}
+
+	if (memcmp(&Config, settings, CONFIG_SAVED_SIZE))
+	{
+		printf("%s: upgraded settings differ\n", name);
+		show_diffs();
+		return false;
+	}
+
+	// The upgrade was saved to a bank, so the next start-up just loads it
+	host_reboot();
+
+	if (Initial_EEPROM_Config_Load())
+	{
+		printf("%s: upgraded again after a reboot\n", name);
+		return false;
+	}
+
+	if (memcmp(&Config, settings, CONFIG_SAVED_SIZE))
+	{
+		printf("%s: settings differ after a reboot\n", name);
+		show_diffs();
+		return false;
+	}
+
+	return true;
+}
+
+int main(int argc, char** argv)
+{
+	int		i;
+	int		fails = 0;
+
+	for (i = 1; i < argc; i++)
+	{
+		if (!test_fixture(argv[i]))
+		{
+			fails++;
+		}
+	}
+
+	printf("migration_test: %d layouts, %d failed\n", (argc - 1), fails);
+
+	return (fails || (argc < 2)) ? 1 : 0;
+}
@@ -0,0 +1,146 @@
+//***********************************************************
+//* powercut_test.c
+//*
+//* Cuts the power part way through background saves of the
+//* config banks. After every cut the next start-up must load
+//* either the new settings or, if the save didn't finish,
+//* the ones from before it. A cut can leave the byte being
+//* programmed with any value.
+//*
+//* Also checks that saving unchanged settings writes nothing.
+//***********************************************************
+
+//***********************************************************
+//* Includes
+//***********************************************************
+
+#include <stdio.h>
+#include <string.h>
+#include <stdbool.h>
+#include <avr/io.h>
+#include <avr/interrupt.h>
+#include "io_cfg.h"
+#include "eeprom.h"
+#include "host_eeprom.h"
+
+//************************************************************
+// Defines
+//************************************************************
+
+#define CONFIG_SAVED_SIZE (sizeof(CONFIG_STRUCT) - sizeof(Config.Upgrade))
+#define TRIALS 20000
+#define MAX_CHANGES 40				// Most settings bytes changed per save
+
+//************************************************************
+// Code
+//************************************************************
+
+uint8_t prior[CONFIG_SAVED_SIZE];	// Settings before the save
+uint8_t wanted[CONFIG_SAVED_SIZE];	// Settings being saved
+
+uint32_t seed = 1;
+
+uint16_t random16(void)
+{
+	seed = (seed * 1103515245UL) + 12345UL;
+
+	return (uint16_t)(seed >> 16);
+}
+
+// Change "count" bytes of the settings, leaving the signature alone
+void change_settings(uint8_t count)
+{
+	uint8_t	*ram = (uint8_t*)&Config;
+	uint8_t	i;
+
+	for (i = 0; i < count; i++)
+	{
+		ram[1 + (random16() % (CONFIG_SAVED_SIZE - 1))] = (uint8_t)random16();
+	}
+}
+
+int main(void)
+{
+	uint16_t trial;
+	uint16_t count, cut;
+	uint16_t finished = 0;
+	uint16_t new_loaded = 0;
+	uint16_t old_loaded = 0;
+	uint16_t fails = 0;
+	bool	done;
+
+	// First start-up saves the defaults
+	memset(ee, 0xFF, sizeof(ee));
+	host_reboot();
+	Initial_EEPROM_Config_Load();
+
+	change_settings(255);
+	Save_Config_to_EEPROM();
+	memcpy(prior, &Config, CONFIG_SAVED_SIZE);
+
+	for (trial = 0; trial < TRIALS; trial++)
+	{
+		count = 1 + (random16() % MAX_CHANGES);
+		change_settings(count);
+		memcpy(wanted, &Config, CONFIG_SAVED_SIZE);
+
+		// Save in the background. One save in three runs to the end.
+		sei();
+		Save_Config_to_EEPROM();
+
+		cut = ((trial % 3) == 0) ? HOST_NO_CUT : (random16() % ((2 * count) + 8));
+		done = host_eeprom_run(cut);
+
+		if (done)
+		{
+			finished++;
+		}
+		else if (random16() & 1)
+		{
+			ee[EEAR] = (uint8_t)random16();
+		}
+
+		host_reboot();
+		Initial_EEPROM_Config_Load();
+
+		if (!memcmp(&Config, wanted, CONFIG_SAVED_SIZE))
+		{
+			new_loaded++;
+		}
+		else if (!done && !memcmp(&Config, prior, CONFIG_SAVED_SIZE))
+		{
+			old_loaded++;
+		}
+		else
+		{
+			if (fails < 5)
+			{
+				printf("  trial %u: wrong settings loaded after a cut at byte %u\n", trial, cut);
+			}
+
+			fails++;
+		}
+
+		memcpy(prior, &Config, CONFIG_SAVED_SIZE);
+	}
+
+	printf("powercut_test: %u saves, %u finished, %u loaded new, %u loaded old, %u failed\n",
+			TRIALS, finished, new_loaded, old_loaded, fails);
+
+	// Saving settings that match the active bank must not touch the eeprom
+	host_reboot();
+	Initial_EEPROM_Config_Load();
+	host_eeprom_writes = 0;
+	Save_Config_to_EEPROM();
+	sei();
+	Save_Config_to_EEPROM();
+	host_eeprom_run(HOST_NO_CUT);
+
+	if (host_eeprom_writes)
+	{
+		printf("powercut_test: saving unchanged settings wrote %u bytes\n", host_eeprom_writes);
+		fails++;
+	}
+
+	return (fails ? 1 : 0);
+}